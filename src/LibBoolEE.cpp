@@ -16,6 +16,8 @@ this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "LibBoolEE.h"
 
+#include <algorithm>
+
 std::vector<std::string> LibBoolEE::singleParse(const std::string & formula, const char op, ErrorReport* errorReport) {
     int start_pos = -1;
     int parity_count = 0;
@@ -145,6 +147,112 @@ bool LibBoolEE::resolveRec(const std::string &source, const Vals & valuation, Er
     }
 }
 
+LibBoolEE::Program LibBoolEE::compile(const std::string &source, const std::vector<std::string> & variables, ErrorReport* errorReport) {
+    Program program;
+    compileRec(removeWhitespaces(source), variables, program, errorReport);
+    return program;
+}
+
+void LibBoolEE::compileRec(const std::string &source, const std::vector<std::string> & variables, Program & program, ErrorReport* errorReport) {
+    // Mirrors resolveRec, so that the same formulas fail with the same errors
+    if (source.empty()) {
+        if (errorReport) {
+            errorReport->type = ErrorReport::ErrorType::EmptySubExpression;
+            errorReport->vecUserData.emplace_back(source);
+            errorReport->strDevData = "bad-txns-null-verifier-empty-sub-expression";
+        }
+        throw std::runtime_error("An empty subexpression was encountered");
+    }
+
+    char current_op = '|';
+    // Try to divide by |
+    std::vector<std::string> subexpressions = singleParse(source, current_op, errorReport);
+    // No | on the top level
+    if (subexpressions.size() == 1) {
+        current_op = '&';
+        subexpressions = singleParse(source, current_op, errorReport);
+    }
+
+    // No valid name found
+    if (subexpressions.size() == 0) {
+        if (errorReport) {
+            errorReport->type = ErrorReport::ErrorType::InvalidQualifierName;
+            errorReport->vecUserData.emplace_back(source);
+            errorReport->strDevData = "bad-txns-null-verifier-no-sub-expressions";
+        }
+        throw std::runtime_error("The subexpression " + source + " is not a valid formula.");
+    }
+
+    // No binary top level operator found
+    else if (subexpressions.size() == 1) {
+        if (source[0] == '!') {
+            compileRec(removeWhitespaces(source.substr(1)), variables, program, errorReport);
+            program.code.emplace_back(Program::NOT, 0);
+        }
+        else if (source[0] == '(') {
+            compileRec(removeWhitespaces(source.substr(1, source.size() - 2)), variables, program, errorReport);
+        }
+        else if (source == "1") {
+            program.code.emplace_back(Program::PUSH_TRUE, 0);
+        }
+        else if (source == "0") {
+            program.code.emplace_back(Program::PUSH_FALSE, 0);
+        }
+        else {
+            auto it = std::find(variables.begin(), variables.end(), source);
+            if (it == variables.end()) {
+                if (errorReport) {
+                    errorReport->type = ErrorReport::ErrorType::VariableNotFound;
+                    errorReport->vecUserData.emplace_back(source);
+                    errorReport->strDevData = "bad-txns-null-verifier-variable-not-found";
+                }
+                throw std::runtime_error("Variable '" + source + "' not found in the interpretation.");
+            }
+            program.code.emplace_back(Program::PUSH_VAR, it - variables.begin());
+        }
+    }
+    else {
+        for (const auto& subexpression : subexpressions) {
+            compileRec(removeWhitespaces(subexpression), variables, program, errorReport);
+        }
+        program.code.emplace_back(current_op == '|' ? Program::OR : Program::AND, subexpressions.size());
+    }
+}
+
+bool LibBoolEE::evaluate(const Program & program, const std::vector<bool> & values) {
+    std::vector<bool> stack;
+    for (const auto& op : program.code) {
+        switch (op.first) {
+            case Program::PUSH_FALSE:
+                stack.push_back(false);
+                break;
+            case Program::PUSH_TRUE:
+                stack.push_back(true);
+                break;
+            case Program::PUSH_VAR:
+                stack.push_back(values.at(op.second));
+                break;
+            case Program::NOT:
+                stack.back() = !stack.back();
+                break;
+            case Program::AND:
+            case Program::OR: {
+                bool result = op.first == Program::AND;
+                for (uint32_t i = 0; i < op.second; i++) {
+                    if (op.first == Program::AND)
+                        result &= stack.back();
+                    else
+                        result |= stack.back();
+                    stack.pop_back();
+                }
+                stack.push_back(result);
+                break;
+            }
+        }
+    }
+    return stack.back();
+}
+
 std::string LibBoolEE::trim(const std::string &source) {
     static const std::string WHITESPACES = " \n\r\t\v\f";
     const size_t front = source.find_first_not_of(WHITESPACES);
@@ -44,9 +44,21 @@ public:
     typedef std::map<std::string, bool> Vals; ///< Valuation of atomic propositions
     typedef std::pair<std::string, bool> Val; ///< A single proposition valuation
 
+    /// A formula parsed once into postfix form. Variables are referred to by their index in the list it was compiled against.
+    struct Program {
+        enum Op : uint8_t { PUSH_FALSE, PUSH_TRUE, PUSH_VAR, NOT, AND, OR };
+        std::vector<std::pair<Op, uint32_t>> code; ///< The operation, and the variable index or the operand count
+    };
+
     // @return	true iff the formula is true under the valuation (where the valuation are pairs (variable,value))
     static bool resolve(const std::string & source, const Vals & valuation,  ErrorReport* errorReport = nullptr);
 
+    // @return	the formula compiled against the given variables, it throws exactly where resolve would for any valuation of them
+    static Program compile(const std::string & source, const std::vector<std::string> & variables, ErrorReport* errorReport = nullptr);
+
+    // @return	true iff the compiled formula is true when variables[i] has the value values[i]
+    static bool evaluate(const Program & program, const std::vector<bool> & values);
+
     // @return  new string made from the source by removing whitespaces
     static std::string removeWhitespaces(const std::string & source);
 
@@ -63,6 +75,9 @@ private:
     static bool resolveRec(const std::string & source, const Vals & valuation, ErrorReport* errorReport = nullptr);
 
 
+    // Append the postfix form of the formula to the program---used internally
+    static void compileRec(const std::string & source, const std::vector<std::string> & variables, Program & program, ErrorReport* errorReport = nullptr);
+
     // @return	new string made from the source by removing the leading and trailing white spaces
     static std::string trim(const std::string & source);
 };
@@ -46,7 +46,7 @@ struct TortureGarden {
 };
 
 // Get a 64-byte hash for given 64-byte input, using given TortureGarden contexts and given algo index
-uint512 GetHash(uint512 inputHash, TortureGarden* garden, unsigned int algo, yespower_local_t* local)
+inline uint512 GetHash(uint512 inputHash, TortureGarden* garden, unsigned int algo, yespower_local_t* local)
 {
     uint512 outputHash;
     switch (algo) {
@@ -147,7 +147,7 @@ uint512 GetHash(uint512 inputHash, TortureGarden* garden, unsigned int algo, yes
 }
 
 // Recursively traverse a given torture garden starting with a given hash and given node within the garden. The hash is overwritten with the final hash.
-uint512 TraverseGarden(TortureGarden* garden, uint512 hash, TortureNode* node, yespower_local_t* local)
+inline uint512 TraverseGarden(TortureGarden* garden, uint512 hash, TortureNode* node, yespower_local_t* local)
 {
     uint512 partialHash = GetHash(hash, garden, node->algo, local);
 
@@ -168,7 +168,7 @@ uint512 TraverseGarden(TortureGarden* garden, uint512 hash, TortureNode* node, y
 }
 
 // Associate child nodes with a parent node
-void LinkNodes(TortureNode* parent, TortureNode* childLeft, TortureNode* childRight)
+inline void LinkNodes(TortureNode* parent, TortureNode* childLeft, TortureNode* childRight)
 {
     parent->childLeft = childLeft;
     parent->childRight = childRight;
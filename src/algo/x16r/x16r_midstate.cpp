@@ -0,0 +1,186 @@
+// Copyright (c) 2022 The Avian Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "x16r_midstate.h"
+
+#include <assert.h>
+#include <string.h>
+
+// Same nibbles as GetHashSelection() in x16r.h
+#define START_OF_LAST_16_NIBBLES_OF_HASH 48
+
+template <typename Context>
+static void X16RInit(int algo, Context* ctx)
+{
+    switch (algo) {
+    case 0: sph_blake512_init(&ctx->blake); break;
+    case 1: sph_bmw512_init(&ctx->bmw); break;
+    case 2: sph_groestl512_init(&ctx->groestl); break;
+    case 3: sph_jh512_init(&ctx->jh); break;
+    case 4: sph_keccak512_init(&ctx->keccak); break;
+    case 5: sph_skein512_init(&ctx->skein); break;
+    case 6: sph_luffa512_init(&ctx->luffa); break;
+    case 7: sph_cubehash512_init(&ctx->cubehash); break;
+    case 8: sph_shavite512_init(&ctx->shavite); break;
+    case 9: sph_simd512_init(&ctx->simd); break;
+    case 10: sph_echo512_init(&ctx->echo); break;
+    case 11: sph_hamsi512_init(&ctx->hamsi); break;
+    case 12: sph_fugue512_init(&ctx->fugue); break;
+    case 13: sph_shabal512_init(&ctx->shabal); break;
+    case 14: sph_whirlpool_init(&ctx->whirlpool); break;
+    case 15: sph_sha512_init(&ctx->sha512); break;
+    default: assert(false);
+    }
+}
+
+template <typename Context>
+static void X16RUpdate(int algo, Context* ctx, const void* data, size_t len)
+{
+    switch (algo) {
+    case 0: sph_blake512(&ctx->blake, data, len); break;
+    case 1: sph_bmw512(&ctx->bmw, data, len); break;
+    case 2: sph_groestl512(&ctx->groestl, data, len); break;
+    case 3: sph_jh512(&ctx->jh, data, len); break;
+    case 4: sph_keccak512(&ctx->keccak, data, len); break;
+    case 5: sph_skein512(&ctx->skein, data, len); break;
+    case 6: sph_luffa512(&ctx->luffa, data, len); break;
+    case 7: sph_cubehash512(&ctx->cubehash, data, len); break;
+    case 8: sph_shavite512(&ctx->shavite, data, len); break;
+    case 9: sph_simd512(&ctx->simd, data, len); break;
+    case 10: sph_echo512(&ctx->echo, data, len); break;
+    case 11: sph_hamsi512(&ctx->hamsi, data, len); break;
+    case 12: sph_fugue512(&ctx->fugue, data, len); break;
+    case 13: sph_shabal512(&ctx->shabal, data, len); break;
+    case 14: sph_whirlpool(&ctx->whirlpool, data, len); break;
+    case 15: sph_sha512(&ctx->sha512, data, len); break;
+    default: assert(false);
+    }
+}
+
+template <typename Context>
+static void X16RClose(int algo, Context* ctx, void* dst)
+{
+    switch (algo) {
+    case 0: sph_blake512_close(&ctx->blake, dst); break;
+    case 1: sph_bmw512_close(&ctx->bmw, dst); break;
+    case 2: sph_groestl512_close(&ctx->groestl, dst); break;
+    case 3: sph_jh512_close(&ctx->jh, dst); break;
+    case 4: sph_keccak512_close(&ctx->keccak, dst); break;
+    case 5: sph_skein512_close(&ctx->skein, dst); break;
+    case 6: sph_luffa512_close(&ctx->luffa, dst); break;
+    case 7: sph_cubehash512_close(&ctx->cubehash, dst); break;
+    case 8: sph_shavite512_close(&ctx->shavite, dst); break;
+    case 9: sph_simd512_close(&ctx->simd, dst); break;
+    case 10: sph_echo512_close(&ctx->echo, dst); break;
+    case 11: sph_hamsi512_close(&ctx->hamsi, dst); break;
+    case 12: sph_fugue512_close(&ctx->fugue, dst); break;
+    case 13: sph_shabal512_close(&ctx->shabal, dst); break;
+    case 14: sph_whirlpool_close(&ctx->whirlpool, dst); break;
+    case 15: sph_sha512_close(&ctx->sha512, dst); break;
+    default: assert(false);
+    }
+}
+
+CX16RMidstate::CX16RMidstate() : fInitialized(false)
+{
+    memset(vSelection, 0, sizeof(vSelection));
+}
+
+void CX16RMidstate::Init(const unsigned char* pprefix, const uint256& hashSelector)
+{
+    for (int i = 0; i < 16; i++)
+        vSelection[i] = hashSelector.GetNibble(START_OF_LAST_16_NIBBLES_OF_HASH + i);
+
+    X16RInit(vSelection[0], &ctxFirst);
+    X16RUpdate(vSelection[0], &ctxFirst, pprefix, PREFIX_SIZE);
+    fInitialized = true;
+}
+
+uint256 CX16RMidstate::Hash(uint32_t nNonce) const
+{
+    assert(fInitialized);
+
+    // The nonce is hashed in its in-memory representation, like HashX16R() does
+    unsigned char vchNonce[sizeof(nNonce)];
+    memcpy(vchNonce, &nNonce, sizeof(nNonce));
+
+    uint512 hash[2];
+    X16RContext ctx = ctxFirst;
+    X16RUpdate(vSelection[0], &ctx, vchNonce, sizeof(vchNonce));
+    X16RClose(vSelection[0], &ctx, static_cast<void*>(&hash[0]));
+
+    for (int i = 1; i < 16; i++) {
+        const uint512& in = hash[(i - 1) & 1];
+        uint512& out = hash[i & 1];
+        X16RInit(vSelection[i], &ctx);
+        X16RUpdate(vSelection[i], &ctx, static_cast<const void*>(&in), 64);
+        X16RClose(vSelection[i], &ctx, static_cast<void*>(&out));
+    }
+
+    return hash[15 & 1].trim256();
+}
+
+void CX16RMidstate::HashLanes(const uint32_t vNonce[X16R_LANES], uint256 vHash[X16R_LANES]) const
+{
+    assert(fInitialized);
+
+    uint512 hash[2][X16R_LANES];
+    for (int k = 0; k < X16R_LANES; k++) {
+        unsigned char vchNonce[sizeof(vNonce[k])];
+        memcpy(vchNonce, &vNonce[k], sizeof(vNonce[k]));
+
+        X16RContext ctx = ctxFirst;
+        X16RUpdate(vSelection[0], &ctx, vchNonce, sizeof(vchNonce));
+        X16RClose(vSelection[0], &ctx, static_cast<void*>(&hash[0][k]));
+    }
+
+    for (int i = 1; i < 16; i++)
+        X16RHashLanes(vSelection[i], hash[(i - 1) & 1], hash[i & 1]);
+
+    for (int k = 0; k < X16R_LANES; k++)
+        vHash[k] = hash[15 & 1][k].trim256();
+}
+
+void X16RHashLanes(int algo, const uint512 vIn[X16R_LANES], uint512 vOut[X16R_LANES])
+{
+    X16RLanesKernel kernel = X16RGetLanesKernel(algo);
+    if (kernel) {
+        kernel(vIn, vOut);
+        return;
+    }
+
+    X16RHashLanesScalar(algo, vIn, vOut);
+}
+
+void X16RHashLanesScalar(int algo, const uint512 vIn[X16R_LANES], uint512 vOut[X16R_LANES])
+{
+    for (int k = 0; k < X16R_LANES; k++) {
+        CX16RMidstate::X16RContext ctx;
+        X16RInit(algo, &ctx);
+        X16RUpdate(algo, &ctx, static_cast<const void*>(&vIn[k]), 64);
+        X16RClose(algo, &ctx, static_cast<void*>(&vOut[k]));
+    }
+}
+
+void HashX16RLanes(const unsigned char* const vpHeader[X16R_LANES], const uint256& hashSelector, uint256 vHash[X16R_LANES])
+{
+    int vSelection[16];
+    for (int i = 0; i < 16; i++)
+        vSelection[i] = hashSelector.GetNibble(START_OF_LAST_16_NIBBLES_OF_HASH + i);
+
+    // The first round absorbs 80 bytes, which the 64 byte kernels don't cover
+    uint512 hash[2][X16R_LANES];
+    for (int k = 0; k < X16R_LANES; k++) {
+        CX16RMidstate::X16RContext ctx;
+        X16RInit(vSelection[0], &ctx);
+        X16RUpdate(vSelection[0], &ctx, vpHeader[k], 80);
+        X16RClose(vSelection[0], &ctx, static_cast<void*>(&hash[0][k]));
+    }
+
+    for (int i = 1; i < 16; i++)
+        X16RHashLanes(vSelection[i], hash[(i - 1) & 1], hash[i & 1]);
+
+    for (int k = 0; k < X16R_LANES; k++)
+        vHash[k] = hash[15 & 1][k].trim256();
+}
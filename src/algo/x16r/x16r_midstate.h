@@ -0,0 +1,99 @@
+// Copyright (c) 2022 The Avian Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef AVN_X16R_MIDSTATE_H
+#define AVN_X16R_MIDSTATE_H
+
+#include "../../uint256.h"
+#include "x16r_multi.h"
+#include "sph_blake.h"
+#include "sph_bmw.h"
+#include "sph_cubehash.h"
+#include "sph_echo.h"
+#include "sph_fugue.h"
+#include "sph_groestl.h"
+#include "sph_hamsi.h"
+#include "sph_jh.h"
+#include "sph_keccak.h"
+#include "sph_luffa.h"
+#include "sph_sha2.h"
+#include "sph_shabal.h"
+#include "sph_shavite.h"
+#include "sph_simd.h"
+#include "sph_skein.h"
+#include "sph_whirlpool.h"
+
+#include <stdint.h>
+
+/**
+ * Incremental X16R hashing of an 80 byte block header for nonce scanning.
+ *
+ * The algorithm order is resolved from the selector hash once (hashPrevBlock
+ * for X16R, the time hash for X16RT) and the first algorithm absorbs the 76
+ * leading header bytes once. Each Hash() call then only feeds the 4 nonce
+ * bytes into a copy of that midstate before running the remaining rounds.
+ * The result is identical to HashX16R() over the full header.
+ */
+class CX16RMidstate
+{
+public:
+    static const size_t PREFIX_SIZE = 76;
+
+    CX16RMidstate();
+
+    /** Absorb the header bytes preceding the nonce, using the given selector hash */
+    void Init(const unsigned char* pprefix, const uint256& hashSelector);
+
+    /** Compute the X16R hash of the header with the given nonce */
+    uint256 Hash(uint32_t nNonce) const;
+
+    /** Compute the X16R hashes of X16R_LANES nonces at once, see HashX16RLanes() */
+    void HashLanes(const uint32_t vNonce[X16R_LANES], uint256 vHash[X16R_LANES]) const;
+
+    bool IsInitialized() const { return fInitialized; }
+
+    /** Context large enough for any of the 16 algorithms */
+    union X16RContext {
+        sph_blake512_context blake;
+        sph_bmw512_context bmw;
+        sph_groestl512_context groestl;
+        sph_jh512_context jh;
+        sph_keccak512_context keccak;
+        sph_skein512_context skein;
+        sph_luffa512_context luffa;
+        sph_cubehash512_context cubehash;
+        sph_shavite512_context shavite;
+        sph_simd512_context simd;
+        sph_echo512_context echo;
+        sph_hamsi512_context hamsi;
+        sph_fugue512_context fugue;
+        sph_shabal512_context shabal;
+        sph_whirlpool_context whirlpool;
+        sph_sha512_context sha512;
+    };
+
+private:
+    X16RContext ctxFirst;
+    int vSelection[16];
+    bool fInitialized;
+};
+
+/**
+ * Hash X16R_LANES 64 byte messages with X16R algorithm `algo`, using the
+ * multi-lane kernel when X16RMultiAutoDetect() selected one.
+ */
+void X16RHashLanes(int algo, const uint512 vIn[X16R_LANES], uint512 vOut[X16R_LANES]);
+
+/** Hash X16R_LANES 64 byte messages with X16R algorithm `algo` one lane at a time with sphlib */
+void X16RHashLanesScalar(int algo, const uint512 vIn[X16R_LANES], uint512 vOut[X16R_LANES]);
+
+/**
+ * X16R hash of X16R_LANES 80 byte headers that share one selector hash
+ * (e.g. X16RT headers from the same time window, or nonces of one block
+ * template). All lanes run the same algorithm at every stage, so the 15
+ * chained rounds are hashed in lockstep. Identical to HashX16R() per lane.
+ */
+void HashX16RLanes(const unsigned char* const vpHeader[X16R_LANES], const uint256& hashSelector, uint256 vHash[X16R_LANES]);
+
+#endif // AVN_X16R_MIDSTATE_H
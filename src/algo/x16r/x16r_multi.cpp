@@ -0,0 +1,300 @@
+// Copyright (c) 2022 The Avian Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "x16r_multi.h"
+
+#include "sph_blake.h"
+#include "sph_keccak.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__amd64__))
+#define ENABLE_X16R_AVX2 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+/** Algorithm indices as used by GetHashSelection() */
+enum {
+    X16R_BLAKE = 0,
+    X16R_KECCAK = 4,
+};
+
+static X16RLanesKernel vKernels[16] = {nullptr};
+
+#ifdef ENABLE_X16R_AVX2
+namespace x16r_avx2
+{
+static inline uint64_t ReadLE64(const unsigned char* ptr)
+{
+    uint64_t x;
+    memcpy(&x, ptr, 8);
+    return x;
+}
+
+static inline void WriteLE64(unsigned char* ptr, uint64_t x)
+{
+    memcpy(ptr, &x, 8);
+}
+
+// Word j of each lane, lane 0 in the lowest 64 bits
+#define LOAD_LANES(in, j, read) \
+    _mm256_set_epi64x((long long)read((in)[3].begin() + 8 * (j)), (long long)read((in)[2].begin() + 8 * (j)), \
+                      (long long)read((in)[1].begin() + 8 * (j)), (long long)read((in)[0].begin() + 8 * (j)))
+
+#define STORE_LANES(out, j, v, write)                                        \
+    do {                                                                     \
+        uint64_t tmp[4];                                                     \
+        _mm256_storeu_si256((__m256i*)tmp, (v));                             \
+        for (int k = 0; k < 4; k++) write((out)[k].begin() + 8 * (j), tmp[k]); \
+    } while (0)
+
+#define ROL64(v, n) _mm256_or_si256(_mm256_slli_epi64((v), (n)), _mm256_srli_epi64((v), 64 - (n)))
+#define ROR64(v, n) _mm256_or_si256(_mm256_srli_epi64((v), (n)), _mm256_slli_epi64((v), 64 - (n)))
+
+static const uint64_t KECCAK_RC[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808AULL, 0x8000000080008000ULL,
+    0x000000000000808BULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008AULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000AULL,
+    0x000000008000808BULL, 0x800000000000008BULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800AULL, 0x800000008000000AULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL};
+
+#define KECCAK_THETA_C(x) \
+    C[x] = _mm256_xor_si256(_mm256_xor_si256(_mm256_xor_si256(A[x], A[x + 5]), _mm256_xor_si256(A[x + 10], A[x + 15])), A[x + 20])
+
+#define KECCAK_THETA_D(x, xm1, xp1)                                       \
+    do {                                                                  \
+        const __m256i D = _mm256_xor_si256(C[xm1], ROL64(C[xp1], 1));    \
+        A[x] = _mm256_xor_si256(A[x], D);                                 \
+        A[x + 5] = _mm256_xor_si256(A[x + 5], D);                         \
+        A[x + 10] = _mm256_xor_si256(A[x + 10], D);                       \
+        A[x + 15] = _mm256_xor_si256(A[x + 15], D);                       \
+        A[x + 20] = _mm256_xor_si256(A[x + 20], D);                       \
+    } while (0)
+
+#define KECCAK_CHI(y)                                                                 \
+    do {                                                                              \
+        A[y] = _mm256_xor_si256(B[y], _mm256_andnot_si256(B[y + 1], B[y + 2]));       \
+        A[y + 1] = _mm256_xor_si256(B[y + 1], _mm256_andnot_si256(B[y + 2], B[y + 3])); \
+        A[y + 2] = _mm256_xor_si256(B[y + 2], _mm256_andnot_si256(B[y + 3], B[y + 4])); \
+        A[y + 3] = _mm256_xor_si256(B[y + 3], _mm256_andnot_si256(B[y + 4], B[y]));   \
+        A[y + 4] = _mm256_xor_si256(B[y + 4], _mm256_andnot_si256(B[y], B[y + 1]));   \
+    } while (0)
+
+/**
+ * Keccak-512 (the pre-SHA3 padding sph_keccak512 uses) of four 64 byte
+ * messages. A 64 byte message plus padding fits the 72 byte rate, so this
+ * is a single permutation. The steps are written out with immediate
+ * rotation counts so the state stays in registers.
+ */
+__attribute__((target("avx2"))) static void Keccak512(const uint512* in, uint512* out)
+{
+    __m256i A[25], B[25], C[5];
+
+    for (int j = 0; j < 8; j++)
+        A[j] = LOAD_LANES(in, j, ReadLE64);
+    A[8] = _mm256_set1_epi64x((long long)0x8000000000000001ULL);
+    for (int j = 9; j < 25; j++)
+        A[j] = _mm256_setzero_si256();
+
+    for (int round = 0; round < 24; round++) {
+        // Theta
+        KECCAK_THETA_C(0); KECCAK_THETA_C(1); KECCAK_THETA_C(2); KECCAK_THETA_C(3); KECCAK_THETA_C(4);
+        KECCAK_THETA_D(0, 4, 1); KECCAK_THETA_D(1, 0, 2); KECCAK_THETA_D(2, 1, 3); KECCAK_THETA_D(3, 2, 4); KECCAK_THETA_D(4, 3, 0);
+        // Rho and pi, B[y + 5 * ((2 * x + 3 * y) % 5)] = ROL64(A[x + 5 * y], rho[x + 5 * y])
+        B[0] = A[0]; B[10] = ROL64(A[1], 1); B[20] = ROL64(A[2], 62); B[5] = ROL64(A[3], 28); B[15] = ROL64(A[4], 27);
+        B[16] = ROL64(A[5], 36); B[1] = ROL64(A[6], 44); B[11] = ROL64(A[7], 6); B[21] = ROL64(A[8], 55); B[6] = ROL64(A[9], 20);
+        B[7] = ROL64(A[10], 3); B[17] = ROL64(A[11], 10); B[2] = ROL64(A[12], 43); B[12] = ROL64(A[13], 25); B[22] = ROL64(A[14], 39);
+        B[23] = ROL64(A[15], 41); B[8] = ROL64(A[16], 45); B[18] = ROL64(A[17], 15); B[3] = ROL64(A[18], 21); B[13] = ROL64(A[19], 8);
+        B[14] = ROL64(A[20], 18); B[24] = ROL64(A[21], 2); B[9] = ROL64(A[22], 61); B[19] = ROL64(A[23], 56); B[4] = ROL64(A[24], 14);
+        // Chi
+        KECCAK_CHI(0); KECCAK_CHI(5); KECCAK_CHI(10); KECCAK_CHI(15); KECCAK_CHI(20);
+        // Iota
+        A[0] = _mm256_xor_si256(A[0], _mm256_set1_epi64x((long long)KECCAK_RC[round]));
+    }
+
+    for (int j = 0; j < 8; j++)
+        STORE_LANES(out, j, A[j], WriteLE64);
+}
+
+#undef KECCAK_CHI
+#undef KECCAK_THETA_D
+#undef KECCAK_THETA_C
+
+static const uint64_t BLAKE512_IV[8] = {
+    0x6A09E667F3BCC908ULL, 0xBB67AE8584CAA73BULL, 0x3C6EF372FE94F82BULL, 0xA54FF53A5F1D36F1ULL,
+    0x510E527FADE682D1ULL, 0x9B05688C2B3E6C1FULL, 0x1F83D9ABFB41BD6BULL, 0x5BE0CD19137E2179ULL};
+
+static const uint64_t BLAKE512_CB[16] = {
+    0x243F6A8885A308D3ULL, 0x13198A2E03707344ULL, 0xA4093822299F31D0ULL, 0x082EFA98EC4E6C89ULL,
+    0x452821E638D01377ULL, 0xBE5466CF34E90C6CULL, 0xC0AC29B7C97C50DDULL, 0x3F84D5B5B5470917ULL,
+    0x9216D5D98979FB1BULL, 0xD1310BA698DFB5ACULL, 0x2FFD72DBD01ADFB7ULL, 0xB8E1AFED6A267E96ULL,
+    0xBA7C9045F12C7F99ULL, 0x24A19947B3916CF7ULL, 0x0801F2E2858EFC16ULL, 0x636920D871574E69ULL};
+
+static const unsigned char BLAKE_SIGMA[10][16] = {
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+    {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
+    {11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4},
+    {7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8},
+    {9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13},
+    {2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9},
+    {12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11},
+    {13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10},
+    {6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5},
+    {10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0}};
+
+static inline uint64_t ReadBE64(const unsigned char* ptr)
+{
+    return __builtin_bswap64(ReadLE64(ptr));
+}
+
+static inline void WriteBE64(unsigned char* ptr, uint64_t x)
+{
+    WriteLE64(ptr, __builtin_bswap64(x));
+}
+
+#define BLAKE_G(r, i, a, b, c, d)                                                                                     \
+    do {                                                                                                              \
+        const unsigned char s0 = BLAKE_SIGMA[(r) % 10][2 * (i)], s1 = BLAKE_SIGMA[(r) % 10][2 * (i) + 1];          \
+        a = _mm256_add_epi64(_mm256_add_epi64(a, b), _mm256_xor_si256(M[s0], _mm256_set1_epi64x((long long)BLAKE512_CB[s1]))); \
+        d = _mm256_shuffle_epi32(_mm256_xor_si256(d, a), 0xB1);                                                       \
+        c = _mm256_add_epi64(c, d);                                                                                   \
+        b = ROR64(_mm256_xor_si256(b, c), 25);                                                                        \
+        a = _mm256_add_epi64(_mm256_add_epi64(a, b), _mm256_xor_si256(M[s1], _mm256_set1_epi64x((long long)BLAKE512_CB[s0]))); \
+        d = ROR64(_mm256_xor_si256(d, a), 16);                                                                        \
+        c = _mm256_add_epi64(c, d);                                                                                   \
+        b = ROR64(_mm256_xor_si256(b, c), 11);                                                                        \
+    } while (0)
+
+/**
+ * BLAKE-512 of four 64 byte messages. The message and its padding fill
+ * exactly one 128 byte block, with a bit counter of 512.
+ */
+__attribute__((target("avx2"))) static void Blake512(const uint512* in, uint512* out)
+{
+    __m256i M[16], V[16];
+
+    for (int j = 0; j < 8; j++)
+        M[j] = LOAD_LANES(in, j, ReadBE64);
+    M[8] = _mm256_set1_epi64x((long long)0x8000000000000000ULL);
+    for (int j = 9; j < 13; j++)
+        M[j] = _mm256_setzero_si256();
+    M[13] = _mm256_set1_epi64x(1);
+    M[14] = _mm256_setzero_si256();
+    M[15] = _mm256_set1_epi64x(512);
+
+    for (int j = 0; j < 8; j++)
+        V[j] = _mm256_set1_epi64x((long long)BLAKE512_IV[j]);
+    for (int j = 8; j < 12; j++)
+        V[j] = _mm256_set1_epi64x((long long)BLAKE512_CB[j - 8]);
+    // Counter T0 = 512, T1 = 0
+    V[12] = _mm256_set1_epi64x((long long)(512 ^ BLAKE512_CB[4]));
+    V[13] = _mm256_set1_epi64x((long long)(512 ^ BLAKE512_CB[5]));
+    V[14] = _mm256_set1_epi64x((long long)BLAKE512_CB[6]);
+    V[15] = _mm256_set1_epi64x((long long)BLAKE512_CB[7]);
+
+    for (int r = 0; r < 16; r++) {
+        BLAKE_G(r, 0, V[0], V[4], V[8], V[12]);
+        BLAKE_G(r, 1, V[1], V[5], V[9], V[13]);
+        BLAKE_G(r, 2, V[2], V[6], V[10], V[14]);
+        BLAKE_G(r, 3, V[3], V[7], V[11], V[15]);
+        BLAKE_G(r, 4, V[0], V[5], V[10], V[15]);
+        BLAKE_G(r, 5, V[1], V[6], V[11], V[12]);
+        BLAKE_G(r, 6, V[2], V[7], V[8], V[13]);
+        BLAKE_G(r, 7, V[3], V[4], V[9], V[14]);
+    }
+
+    // No salt, so H' = H ^ V[i] ^ V[i + 8]
+    for (int j = 0; j < 8; j++) {
+        __m256i H = _mm256_xor_si256(_mm256_set1_epi64x((long long)BLAKE512_IV[j]), _mm256_xor_si256(V[j], V[j + 8]));
+        STORE_LANES(out, j, H, WriteBE64);
+    }
+}
+
+#undef BLAKE_G
+#undef ROR64
+#undef ROL64
+#undef STORE_LANES
+#undef LOAD_LANES
+
+/** AVX2 usable by the CPU and enabled by the OS */
+static bool Available()
+{
+    uint32_t eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return false;
+    // OSXSAVE and AVX
+    if (!((ecx >> 27) & 1) || !((ecx >> 28) & 1))
+        return false;
+    uint32_t xcr0_lo, xcr0_hi;
+    __asm__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+    // XMM and YMM state saved on context switches
+    if ((xcr0_lo & 6) != 6)
+        return false;
+    if (__get_cpuid_max(0, nullptr) < 7)
+        return false;
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    return (ebx >> 5) & 1;
+}
+} // namespace x16r_avx2
+#endif
+
+typedef void (*ScalarHashFn)(const uint512& in, uint512& out);
+
+static void ScalarBlake512(const uint512& in, uint512& out)
+{
+    sph_blake512_context ctx;
+    sph_blake512_init(&ctx);
+    sph_blake512(&ctx, in.begin(), in.size());
+    sph_blake512_close(&ctx, out.begin());
+}
+
+static void ScalarKeccak512(const uint512& in, uint512& out)
+{
+    sph_keccak512_context ctx;
+    sph_keccak512_init(&ctx);
+    sph_keccak512(&ctx, in.begin(), in.size());
+    sph_keccak512_close(&ctx, out.begin());
+}
+
+/** Compare a multi-lane kernel against the sphlib implementation on distinct lanes */
+static bool SelfTest(X16RLanesKernel kernel, ScalarHashFn scalar)
+{
+    uint512 in[X16R_LANES], out[X16R_LANES];
+    for (int k = 0; k < X16R_LANES; k++)
+        for (unsigned int i = 0; i < in[k].size(); i++)
+            in[k].begin()[i] = (unsigned char)(i * 7 + k * 31 + 1);
+
+    kernel(in, out);
+    for (int k = 0; k < X16R_LANES; k++) {
+        uint512 expected;
+        scalar(in[k], expected);
+        if (expected != out[k])
+            return false;
+    }
+    return true;
+}
+
+std::string X16RMultiAutoDetect()
+{
+#ifdef ENABLE_X16R_AVX2
+    if (x16r_avx2::Available()) {
+        assert(SelfTest(x16r_avx2::Blake512, ScalarBlake512));
+        assert(SelfTest(x16r_avx2::Keccak512, ScalarKeccak512));
+        vKernels[X16R_BLAKE] = x16r_avx2::Blake512;
+        vKernels[X16R_KECCAK] = x16r_avx2::Keccak512;
+        return "avx2(blake,keccak)";
+    }
+#endif
+    return "standard";
+}
+
+X16RLanesKernel X16RGetLanesKernel(int algo)
+{
+    assert(algo >= 0 && algo < 16);
+    return vKernels[algo];
+}
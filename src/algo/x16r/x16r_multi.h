@@ -0,0 +1,30 @@
+// Copyright (c) 2022 The Avian Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef AVN_X16R_MULTI_H
+#define AVN_X16R_MULTI_H
+
+#include "../../uint256.h"
+
+#include <string>
+
+/** Number of independent messages hashed in lockstep by the multi-lane kernels */
+static const int X16R_LANES = 4;
+
+/**
+ * Multi-lane kernel for one X16R algorithm: hashes X16R_LANES independent
+ * 64 byte messages (the intermediate hashes of the X16R chain) at once.
+ */
+typedef void (*X16RLanesKernel)(const uint512* in, uint512* out);
+
+/** Autodetect the best available multi-lane kernels. Returns name of the implementation. */
+std::string X16RMultiAutoDetect();
+
+/**
+ * Return the multi-lane kernel for algorithm `algo` (0..15, in GetHashSelection()
+ * order), or nullptr if that algorithm only has a scalar implementation on this CPU.
+ */
+X16RLanesKernel X16RGetLanesKernel(int algo);
+
+#endif // AVN_X16R_MULTI_H
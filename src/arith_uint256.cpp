@@ -95,6 +95,17 @@ base_uint<BITS>& base_uint<BITS>::operator/=(const base_uint& b)
         throw uint_error("Division by zero");
     if (div_bits > num_bits) // the result is certainly 0.
         return *this;
+    if (div_bits <= 32) {
+        // Short division, one 32 bit limb at a time. The remainder is always below the divisor, so it fits in 32 bits.
+        uint64_t divisor = div.pn[0];
+        uint64_t remainder = 0;
+        for (int i = WIDTH - 1; i >= 0; i--) {
+            uint64_t cur = (remainder << 32) | num.pn[i];
+            pn[i] = (uint32_t)(cur / divisor);
+            remainder = cur % divisor;
+        }
+        return *this;
+    }
     int shift = num_bits - div_bits;
     div <<= shift; // shift so that div and num align.
     while (shift >= 0) {
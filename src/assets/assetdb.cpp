@@ -135,7 +135,7 @@ bool CAssetsDB::LoadAssets()
 
                 // Loaded enough from database to have in memory.
                 // No need to load everything if it is just going to be removed from the cache
-                if (passetsCache->Size() == (passetsCache->MaxSize() / 2))
+                if (passetsCache->DynamicMemoryUsage() >= passetsCache->MaxMemory() / 2)
                     break;
             } else {
                 return error("%s: failed to read asset", __func__);
@@ -333,6 +333,9 @@ bool CAssetsDB::AssetAddressDir(std::vector<std::pair<std::string, CAmount> >& v
             std::pair<char, std::pair<std::string, std::string> > key;
             if (pcursor->GetKey(key) && key.first == ASSET_ADDRESS_QUANTITY_FLAG && key.second.first == assetName) {
                 totalEntries += 1;
+            } else {
+                // Keys are sorted, so we are past the entries of this asset
+                break;
             }
             pcursor->Next();
         }
@@ -389,6 +392,50 @@ bool CAssetsDB::AssetAddressDir(std::vector<std::pair<std::string, CAmount> >& v
     return true;
 }
 
+bool CAssetsDB::AssetAddressDirFrom(std::vector<std::pair<std::string, CAmount> >& vecAddressAmount, const std::string& assetName, const std::string& strAfterAddress, const size_t count, std::string& strNextAddress)
+{
+    strNextAddress.clear();
+    if (count == 0)
+        return true;
+
+    // Seek straight to the cursor instead of skipping over the preceding entries
+    std::unique_ptr<CDBIterator> pcursor(NewIterator());
+    pcursor->Seek(std::make_pair(ASSET_ADDRESS_QUANTITY_FLAG, std::make_pair(assetName, strAfterAddress)));
+
+    size_t loaded = 0;
+    std::string strLastAddress;
+    while (pcursor->Valid()) {
+        boost::this_thread::interruption_point();
+
+        std::pair<char, std::pair<std::string, std::string> > key;
+        if (!pcursor->GetKey(key) || key.first != ASSET_ADDRESS_QUANTITY_FLAG || key.second.first != assetName)
+            break;
+
+        if (!strAfterAddress.empty() && key.second.second == strAfterAddress) {
+            // The cursor entry itself was returned by the previous page
+            pcursor->Next();
+            continue;
+        }
+
+        if (loaded >= count || loaded >= MAX_DATABASE_RESULTS) {
+            // There are more entries, hand out a cursor to continue from
+            strNextAddress = strLastAddress;
+            break;
+        }
+
+        CAmount amount;
+        if (!pcursor->GetValue(amount))
+            return error("%s: failed to Asset Address Quanity", __func__);
+
+        vecAddressAmount.emplace_back(std::make_pair(key.second.second, amount));
+        strLastAddress = key.second.second;
+        loaded += 1;
+        pcursor->Next();
+    }
+
+    return true;
+}
+
 bool CAssetsDB::AssetDir(std::vector<CDatabasedAssetData>& assets)
 {
     return CAssetsDB::AssetDir(assets, "*", MAX_SIZE, 0);
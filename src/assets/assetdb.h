@@ -97,6 +97,11 @@ public:
 
     bool AddressDir(std::vector<std::pair<std::string, CAmount> >& vecAssetAmount, int& totalEntries, const bool& fGetTotal, const std::string& address, const size_t count, const long start);
     bool AssetAddressDir(std::vector<std::pair<std::string, CAmount> >& vecAddressAmount, int& totalEntries, const bool& fGetTotal, const std::string& assetName, const size_t count, const long start);
+
+    /** Page through the holders of an asset in address order, starting right after strAfterAddress
+     * (from the first holder when it is empty). strNextAddress is set to the cursor to pass for the
+     * next page, or cleared when all holders were returned. Does not flush the asset cache. */
+    bool AssetAddressDirFrom(std::vector<std::pair<std::string, CAmount> >& vecAddressAmount, const std::string& assetName, const std::string& strAfterAddress, const size_t count, std::string& strNextAddress);
 };
 
 
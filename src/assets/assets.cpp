@@ -690,180 +690,178 @@ bool OwnerFromTransaction(const CTransaction& tx, std::string& ownerName, std::s
     return OwnerAssetFromScript(scriptPubKey, ownerName, strAddress);
 }
 
-bool TransferAssetFromScript(const CScript& scriptPubKey, CAssetTransfer& assetTransfer, std::string& strAddress)
-{
-    int nStartingIndex = 0;
-    if (!IsScriptTransferAsset(scriptPubKey, nStartingIndex)) {
-        return false;
-    }
-
-    CTxDestination destination;
-    ExtractDestination(scriptPubKey, destination);
-
-    strAddress = EncodeDestination(destination);
+/** The asset data of an asset script, deserialized once and shared by every check of the same script */
+struct CParsedAssetScript
+{
+    bool fParsed;                 //! Whether the asset data deserialized
+    CTxDestination destination;   //! Where the script pays to
+    std::string strAddress;       //! destination, base58 encoded
+    CNewAsset asset;              //! TX_NEW_ASSET
+    AssetType assetType;          //! TX_NEW_ASSET, the type of asset.strName, AssetType::INVALID if the name is not valid
+    std::string strOwnerName;     //! TX_NEW_ASSET owner
+    CReissueAsset reissue;        //! TX_REISSUE_ASSET
+    CAssetTransfer transfer;      //! TX_TRANSFER_ASSET
+
+    CParsedAssetScript() : fParsed(false), assetType(AssetType::INVALID) {}
+};
 
-    std::vector<unsigned char> vchTransferAsset;
+static CCriticalSection cs_parsedAssetScripts;
+static CLRUCache<uint256, std::shared_ptr<const CParsedAssetScript>, BlockHasher> cacheParsedAssetScripts(MAX_PARSED_ASSET_SCRIPTS);
 
-    vchTransferAsset.insert(vchTransferAsset.end(), scriptPubKey.begin() + nStartingIndex, scriptPubKey.end());
+/** Returns the asset data of an asset script, nType, fIsOwner and nStartingIndex being what IsAssetScript found in it.
+ * Parsed scripts are kept by the hash of their bytes, so the same output checked by the mempool, the block, the indexes
+ * and the wallet is only read once. Only scripts that parse are kept, so invalid ones can't push valid ones out. */
+static std::shared_ptr<const CParsedAssetScript> GetParsedAssetScript(const CScript& scriptPubKey, int nType, bool fIsOwner, int nStartingIndex)
+{
+    uint256 hash = Hash(scriptPubKey.begin(), scriptPubKey.end());
+    {
+        LOCK(cs_parsedAssetScripts);
+        if (cacheParsedAssetScripts.Exists(hash))
+            return cacheParsedAssetScripts.Get(hash);
+    }
 
-    CDataStream ssAsset(vchTransferAsset, SER_NETWORK, PROTOCOL_VERSION);
+    auto parsed = std::make_shared<CParsedAssetScript>();
+    ExtractDestination(scriptPubKey, parsed->destination);
+    parsed->strAddress = EncodeDestination(parsed->destination);
 
+    CDataStream ssAsset(std::vector<unsigned char>(scriptPubKey.begin() + nStartingIndex, scriptPubKey.end()), SER_NETWORK, PROTOCOL_VERSION);
     try {
-        ssAsset >> assetTransfer;
+        if (nType == TX_TRANSFER_ASSET) {
+            ssAsset >> parsed->transfer;
+        } else if (nType == TX_NEW_ASSET && fIsOwner) {
+            ssAsset >> parsed->strOwnerName;
+        } else if (nType == TX_NEW_ASSET) {
+            ssAsset >> parsed->asset;
+            if (!IsAssetNameValid(parsed->asset.strName, parsed->assetType))
+                parsed->assetType = AssetType::INVALID;
+        } else if (nType == TX_REISSUE_ASSET) {
+            ssAsset >> parsed->reissue;
+        }
+        parsed->fParsed = true;
     } catch(std::exception& e) {
-        error("Failed to get the transfer asset from the stream: %s", e.what());
-        return false;
+        error("Failed to get the asset data from the stream: %s", e.what());
     }
 
-    return true;
+    if (parsed->fParsed && !(nType == TX_NEW_ASSET && !fIsOwner && parsed->assetType == AssetType::INVALID)) {
+        LOCK(cs_parsedAssetScripts);
+        cacheParsedAssetScripts.Put(hash, parsed);
+    }
+    return parsed;
 }
 
-bool AssetFromScript(const CScript& scriptPubKey, CNewAsset& assetNew, std::string& strAddress)
+size_t GetParsedAssetScriptsCacheSize()
 {
-    int nStartingIndex = 0;
-    if (!IsScriptNewAsset(scriptPubKey, nStartingIndex))
-        return false;
-
-    CTxDestination destination;
-    ExtractDestination(scriptPubKey, destination);
+    LOCK(cs_parsedAssetScripts);
+    return cacheParsedAssetScripts.Size();
+}
 
-    strAddress = EncodeDestination(destination);
+/** Returns the asset data of the script if it is an asset script, nullptr otherwise */
+static std::shared_ptr<const CParsedAssetScript> GetParsedAssetScript(const CScript& scriptPubKey, int& nType, bool& fIsOwner)
+{
+    int nStartingIndex = 0;
+    if (!scriptPubKey.IsAssetScript(nType, fIsOwner, nStartingIndex))
+        return nullptr;
 
-    std::vector<unsigned char> vchNewAsset;
-    vchNewAsset.insert(vchNewAsset.end(), scriptPubKey.begin() + nStartingIndex, scriptPubKey.end());
-    CDataStream ssAsset(vchNewAsset, SER_NETWORK, PROTOCOL_VERSION);
+    return GetParsedAssetScript(scriptPubKey, nType, fIsOwner, nStartingIndex);
+}
 
-    try {
-        ssAsset >> assetNew;
-    } catch(std::exception& e) {
-        error("Failed to get the asset from the stream: %s", e.what());
+bool TransferAssetFromScript(const CScript& scriptPubKey, CAssetTransfer& assetTransfer, std::string& strAddress)
+{
+    int nType = 0;
+    bool fIsOwner = false;
+    auto parsed = GetParsedAssetScript(scriptPubKey, nType, fIsOwner);
+    if (!parsed || nType != TX_TRANSFER_ASSET || !parsed->fParsed)
         return false;
-    }
+
+    strAddress = parsed->strAddress;
+    assetTransfer = parsed->transfer;
 
     return true;
 }
 
-bool MsgChannelAssetFromScript(const CScript& scriptPubKey, CNewAsset& assetNew, std::string& strAddress)
+bool AssetFromScript(const CScript& scriptPubKey, CNewAsset& assetNew, std::string& strAddress)
 {
-    int nStartingIndex = 0;
-    if (!IsScriptNewMsgChannelAsset(scriptPubKey, nStartingIndex))
+    int nType = 0;
+    bool fIsOwner = false;
+    auto parsed = GetParsedAssetScript(scriptPubKey, nType, fIsOwner);
+    if (!parsed || nType != TX_NEW_ASSET || fIsOwner || !parsed->fParsed)
         return false;
 
-    CTxDestination destination;
-    ExtractDestination(scriptPubKey, destination);
-
-    strAddress = EncodeDestination(destination);
+    strAddress = parsed->strAddress;
+    assetNew = parsed->asset;
 
-    std::vector<unsigned char> vchNewAsset;
-    vchNewAsset.insert(vchNewAsset.end(), scriptPubKey.begin() + nStartingIndex, scriptPubKey.end());
-    CDataStream ssAsset(vchNewAsset, SER_NETWORK, PROTOCOL_VERSION);
+    return true;
+}
 
-    try {
-        ssAsset >> assetNew;
-    } catch(std::exception& e) {
-        error("Failed to get the msg channel asset from the stream: %s", e.what());
+bool MsgChannelAssetFromScript(const CScript& scriptPubKey, CNewAsset& assetNew, std::string& strAddress)
+{
+    int nType = 0;
+    bool fIsOwner = false;
+    auto parsed = GetParsedAssetScript(scriptPubKey, nType, fIsOwner);
+    if (!parsed || nType != TX_NEW_ASSET || fIsOwner || !parsed->fParsed
+        || parsed->assetType != AssetType::MSGCHANNEL)
         return false;
-    }
+
+    strAddress = parsed->strAddress;
+    assetNew = parsed->asset;
 
     return true;
 }
 
 bool QualifierAssetFromScript(const CScript& scriptPubKey, CNewAsset& assetNew, std::string& strAddress)
 {
-    int nStartingIndex = 0;
-    if (!IsScriptNewQualifierAsset(scriptPubKey, nStartingIndex))
+    int nType = 0;
+    bool fIsOwner = false;
+    auto parsed = GetParsedAssetScript(scriptPubKey, nType, fIsOwner);
+    if (!parsed || nType != TX_NEW_ASSET || fIsOwner || !parsed->fParsed
+        || (parsed->assetType != AssetType::QUALIFIER && parsed->assetType != AssetType::SUB_QUALIFIER))
         return false;
 
-    CTxDestination destination;
-    ExtractDestination(scriptPubKey, destination);
-
-    strAddress = EncodeDestination(destination);
-
-    std::vector<unsigned char> vchNewAsset;
-    vchNewAsset.insert(vchNewAsset.end(), scriptPubKey.begin() + nStartingIndex, scriptPubKey.end());
-    CDataStream ssAsset(vchNewAsset, SER_NETWORK, PROTOCOL_VERSION);
-
-    try {
-        ssAsset >> assetNew;
-    } catch(std::exception& e) {
-        error("Failed to get the qualifier asset from the stream: %s", e.what());
-        return false;
-    }
+    strAddress = parsed->strAddress;
+    assetNew = parsed->asset;
 
     return true;
 }
 
 bool RestrictedAssetFromScript(const CScript& scriptPubKey, CNewAsset& assetNew, std::string& strAddress)
 {
-    int nStartingIndex = 0;
-    if (!IsScriptNewRestrictedAsset(scriptPubKey, nStartingIndex))
+    int nType = 0;
+    bool fIsOwner = false;
+    auto parsed = GetParsedAssetScript(scriptPubKey, nType, fIsOwner);
+    if (!parsed || nType != TX_NEW_ASSET || fIsOwner || !parsed->fParsed
+        || parsed->assetType != AssetType::RESTRICTED)
         return false;
 
-    CTxDestination destination;
-    ExtractDestination(scriptPubKey, destination);
-
-    strAddress = EncodeDestination(destination);
-
-    std::vector<unsigned char> vchNewAsset;
-    vchNewAsset.insert(vchNewAsset.end(), scriptPubKey.begin() + nStartingIndex, scriptPubKey.end());
-    CDataStream ssAsset(vchNewAsset, SER_NETWORK, PROTOCOL_VERSION);
-
-    try {
-        ssAsset >> assetNew;
-    } catch(std::exception& e) {
-        error("Failed to get the restricted asset from the stream: %s", e.what());
-        return false;
-    }
+    strAddress = parsed->strAddress;
+    assetNew = parsed->asset;
 
     return true;
 }
 
 bool OwnerAssetFromScript(const CScript& scriptPubKey, std::string& assetName, std::string& strAddress)
 {
-    int nStartingIndex = 0;
-    if (!IsScriptOwnerAsset(scriptPubKey, nStartingIndex))
+    int nType = 0;
+    bool fIsOwner = false;
+    auto parsed = GetParsedAssetScript(scriptPubKey, nType, fIsOwner);
+    if (!parsed || nType != TX_NEW_ASSET || !fIsOwner || !parsed->fParsed)
         return false;
 
-    CTxDestination destination;
-    ExtractDestination(scriptPubKey, destination);
-
-    strAddress = EncodeDestination(destination);
-
-    std::vector<unsigned char> vchOwnerAsset;
-    vchOwnerAsset.insert(vchOwnerAsset.end(), scriptPubKey.begin() + nStartingIndex, scriptPubKey.end());
-    CDataStream ssOwner(vchOwnerAsset, SER_NETWORK, PROTOCOL_VERSION);
-
-    try {
-        ssOwner >> assetName;
-    } catch(std::exception& e) {
-        error("Failed to get the owner asset from the stream: %s", e.what());
-        return false;
-    }
+    strAddress = parsed->strAddress;
+    assetName = parsed->strOwnerName;
 
     return true;
 }
 
 bool ReissueAssetFromScript(const CScript& scriptPubKey, CReissueAsset& reissue, std::string& strAddress)
 {
-    int nStartingIndex = 0;
-    if (!IsScriptReissueAsset(scriptPubKey, nStartingIndex))
+    int nType = 0;
+    bool fIsOwner = false;
+    auto parsed = GetParsedAssetScript(scriptPubKey, nType, fIsOwner);
+    if (!parsed || nType != TX_REISSUE_ASSET || !parsed->fParsed)
         return false;
 
-    CTxDestination destination;
-    ExtractDestination(scriptPubKey, destination);
-
-    strAddress = EncodeDestination(destination);
-
-    std::vector<unsigned char> vchReissueAsset;
-    vchReissueAsset.insert(vchReissueAsset.end(), scriptPubKey.begin() + nStartingIndex, scriptPubKey.end());
-    CDataStream ssReissue(vchReissueAsset, SER_NETWORK, PROTOCOL_VERSION);
-
-    try {
-        ssReissue >> reissue;
-    } catch(std::exception& e) {
-        error("Failed to get the reissue asset from the stream: %s", e.what());
-        return false;
-    }
+    strAddress = parsed->strAddress;
+    reissue = parsed->reissue;
 
     return true;
 }
@@ -1698,6 +1696,12 @@ bool CAssetsCache::AddTransferAsset(const CAssetTransfer& transferAsset, const s
     return true;
 }
 
+CAssetsCache::CAssetsCache(CAssetsCache* baseIn) : CAssets(), pbase(baseIn == passets ? nullptr : baseIn)
+{
+    SetNull();
+    ClearDirtyCache();
+}
+
 void CAssetsCache::AddToAssetBalance(const std::string& strName, const std::string& address, const CAmount& nAmount)
 {
     if (fAssetIndex) {
@@ -2856,6 +2860,9 @@ bool CAssetsCache::Flush()
     if (!passets)
         return error("%s: Couldn't find passets pointer while trying to flush assets cache", __func__);
 
+    if (pbase)
+        return error("%s: Can't flush an assets cache that isn't layered directly on top of passets", __func__);
+
     try {
         for (auto &item : setNewAssetsToAdd) {
             if (passets->setNewAssetsToRemove.count(item))
@@ -3034,11 +3041,67 @@ bool CAssetsCache::Flush()
     }
 }
 
-//! Get the amount of memory the cache is using
+//! Heap memory of the strings held by the entries of the cache, at their actual capacity
+static size_t StringsUsage(const std::string& str) { return memusage::DynamicUsage(str); }
+static size_t StringsUsage(const CNewAsset& asset) { return StringsUsage(asset.strName) + StringsUsage(asset.strIPFSHash) + StringsUsage(asset.strANSID); }
+static size_t StringsUsage(const CReissueAsset& reissue) { return StringsUsage(reissue.strName) + StringsUsage(reissue.strIPFSHash) + StringsUsage(reissue.strANSID); }
+static size_t StringsUsage(const CAssetTransfer& transfer) { return StringsUsage(transfer.strName) + StringsUsage(transfer.message); }
+static size_t StringsUsage(const CAssetCacheNewAsset& item) { return StringsUsage(item.asset) + StringsUsage(item.address); }
+static size_t StringsUsage(const CAssetCacheReissueAsset& item) { return StringsUsage(item.reissue) + StringsUsage(item.address); }
+static size_t StringsUsage(const CAssetCacheNewTransfer& item) { return StringsUsage(item.transfer) + StringsUsage(item.address); }
+static size_t StringsUsage(const CAssetCacheNewOwner& item) { return StringsUsage(item.assetName) + StringsUsage(item.address); }
+static size_t StringsUsage(const CAssetCacheUndoAssetAmount& item) { return StringsUsage(item.assetName) + StringsUsage(item.address); }
+static size_t StringsUsage(const CAssetCacheSpendAsset& item) { return StringsUsage(item.assetName) + StringsUsage(item.address); }
+static size_t StringsUsage(const CAssetCacheQualifierAddress& item) { return StringsUsage(item.assetName) + StringsUsage(item.address); }
+static size_t StringsUsage(const CAssetCacheRestrictedAddress& item) { return StringsUsage(item.assetName) + StringsUsage(item.address); }
+static size_t StringsUsage(const CAssetCacheRestrictedGlobal& item) { return StringsUsage(item.assetName); }
+static size_t StringsUsage(const CAssetCacheRestrictedVerifiers& item) { return StringsUsage(item.assetName) + StringsUsage(item.verifier); }
+
+//! Memory of a container of the cache, its nodes and the strings held by its entries
+template <typename Container>
+static size_t ContainerUsage(const Container& container)
+{
+    size_t size = memusage::DynamicUsage(container);
+    for (const auto& item : container)
+        size += StringsUsage(item);
+    return size;
+}
+
+//! Get the amount of memory the cache is using, including the dirty entries waiting to be databased
 size_t CAssetsCache::DynamicMemoryUsage() const
 {
-    // TODO make sure this is accurate
-    return memusage::DynamicUsage(mapAssetsAddressAmount) + memusage::DynamicUsage(mapReissuedAssetData);
+    // Asset Name, Address -> Amount and Asset Name -> Reissued Asset Data
+    size_t size = memusage::DynamicUsage(mapAssetsAddressAmount);
+    for (const auto& item : mapAssetsAddressAmount)
+        size += StringsUsage(item.first.first) + StringsUsage(item.first.second);
+    size += memusage::DynamicUsage(mapReissuedAssetData);
+    for (const auto& item : mapReissuedAssetData)
+        size += StringsUsage(item.first) + StringsUsage(item.second);
+
+    return size + DirtyMemoryUsage();
+}
+
+//! Get the amount of memory held by the dirty entries waiting to be databased
+size_t CAssetsCache::DirtyMemoryUsage() const
+{
+    size_t size = ContainerUsage(vUndoAssetAmount) + ContainerUsage(vSpentAssets);
+    size += ContainerUsage(setNewAssetsToAdd) + ContainerUsage(setNewAssetsToRemove);
+    size += ContainerUsage(setNewReissueToAdd) + ContainerUsage(setNewReissueToRemove);
+    size += ContainerUsage(setNewTransferAssetsToAdd) + ContainerUsage(setNewTransferAssetsToRemove);
+    size += ContainerUsage(setNewOwnerAssetsToAdd) + ContainerUsage(setNewOwnerAssetsToRemove);
+    size += ContainerUsage(setNewQualifierAddressToAdd) + ContainerUsage(setNewQualifierAddressToRemove);
+    size += ContainerUsage(setNewRestrictedAddressToAdd) + ContainerUsage(setNewRestrictedAddressToRemove);
+    size += ContainerUsage(setNewRestrictedGlobalToAdd) + ContainerUsage(setNewRestrictedGlobalToRemove);
+    size += ContainerUsage(setNewRestrictedVerifierToAdd) + ContainerUsage(setNewRestrictedVerifierToRemove);
+
+    // Root Asset Name, Address -> Qualifier Names
+    for (const auto* mapRoot : {&mapRootQualifierAddressesAdd, &mapRootQualifierAddressesRemove}) {
+        size += memusage::DynamicUsage(*mapRoot);
+        for (const auto& item : *mapRoot)
+            size += StringsUsage(item.first.rootAssetName) + StringsUsage(item.first.address) + ContainerUsage(item.second);
+    }
+
+    return size;
 }
 
 //! Get an estimated size of the cache in bytes that will be needed inorder to save to database
@@ -3230,15 +3293,14 @@ bool IsScriptNewUniqueAsset(const CScript &scriptPubKey, int &nStartingIndex)
     if (!scriptPubKey.IsAssetScript(nType, fIsOwner, nStartingIndex))
         return false;
 
-    CNewAsset asset;
-    std::string address;
-    if (!AssetFromScript(scriptPubKey, asset, address))
+    if (nType != TX_NEW_ASSET || fIsOwner)
         return false;
 
-    AssetType assetType;
-    if (!IsAssetNameValid(asset.strName, assetType))
+    auto parsed = GetParsedAssetScript(scriptPubKey, nType, fIsOwner, nStartingIndex);
+    if (!parsed->fParsed)
         return false;
 
+    AssetType assetType = parsed->assetType;
     return AssetType::UNIQUE == assetType;
 }
 
@@ -3255,15 +3317,14 @@ bool IsScriptNewMsgChannelAsset(const CScript &scriptPubKey, int &nStartingIndex
     if (!scriptPubKey.IsAssetScript(nType, fIsOwner, nStartingIndex))
         return false;
 
-    CNewAsset asset;
-    std::string address;
-    if (!AssetFromScript(scriptPubKey, asset, address))
+    if (nType != TX_NEW_ASSET || fIsOwner)
         return false;
 
-    AssetType assetType;
-    if (!IsAssetNameValid(asset.strName, assetType))
+    auto parsed = GetParsedAssetScript(scriptPubKey, nType, fIsOwner, nStartingIndex);
+    if (!parsed->fParsed)
         return false;
 
+    AssetType assetType = parsed->assetType;
     return AssetType::MSGCHANNEL == assetType;
 }
 
@@ -3332,15 +3393,14 @@ bool IsScriptNewQualifierAsset(const CScript &scriptPubKey, int &nStartingIndex)
     if (!scriptPubKey.IsAssetScript(nType, fIsOwner, nStartingIndex))
         return false;
 
-    CNewAsset asset;
-    std::string address;
-    if (!AssetFromScript(scriptPubKey, asset, address))
+    if (nType != TX_NEW_ASSET || fIsOwner)
         return false;
 
-    AssetType assetType;
-    if (!IsAssetNameValid(asset.strName, assetType))
+    auto parsed = GetParsedAssetScript(scriptPubKey, nType, fIsOwner, nStartingIndex);
+    if (!parsed->fParsed)
         return false;
 
+    AssetType assetType = parsed->assetType;
     return AssetType::QUALIFIER == assetType || AssetType::SUB_QUALIFIER == assetType;
 }
 
@@ -3357,15 +3417,14 @@ bool IsScriptNewRestrictedAsset(const CScript &scriptPubKey, int &nStartingIndex
     if (!scriptPubKey.IsAssetScript(nType, fIsOwner, nStartingIndex))
         return false;
 
-    CNewAsset asset;
-    std::string address;
-    if (!AssetFromScript(scriptPubKey, asset, address))
+    if (nType != TX_NEW_ASSET || fIsOwner)
         return false;
 
-    AssetType assetType;
-    if (!IsAssetNameValid(asset.strName, assetType))
+    auto parsed = GetParsedAssetScript(scriptPubKey, nType, fIsOwner, nStartingIndex);
+    if (!parsed->fParsed)
         return false;
 
+    AssetType assetType = parsed->assetType;
     return AssetType::RESTRICTED == assetType;
 }
 
@@ -3373,6 +3432,7 @@ bool IsScriptNewRestrictedAsset(const CScript &scriptPubKey, int &nStartingIndex
 //! Returns a boolean on if the asset exists
 bool CAssetsCache::CheckIfAssetExists(const std::string& name, bool fForceDuplicateCheck)
 {
+    AssertNotLayered();
     // If we are reindexing, we don't know if an asset exists when accepting blocks
     if (fReindex) {
         return true;
@@ -3449,6 +3509,7 @@ bool CAssetsCache::GetAssetMetaDataIfExists(const std::string &name, CNewAsset &
 
 bool CAssetsCache::GetAssetMetaDataIfExists(const std::string &name, CNewAsset &asset, int& nHeight, uint256& blockHash)
 {
+    AssertNotLayered();
     // Check the map that contains the reissued asset data. If it is in this map, it hasn't been saved to disk yet
     if (mapReissuedAssetData.count(name)) {
         asset = mapReissuedAssetData.at(name);
@@ -3496,9 +3557,8 @@ bool CAssetsCache::GetAssetMetaDataIfExists(const std::string &name, CNewAsset &
 
     // Check the cache, if it doesn't exist in the cache. Try and read it from database
     if (passetsCache) {
-        if (passetsCache->Exists(name)) {
-            CDatabasedAssetData data;
-            data = passetsCache->Get(name);
+        CDatabasedAssetData data;
+        if (passetsCache->Lookup(name, data)) {
             asset = data.asset;
             nHeight = data.nHeight;
             blockHash = data.blockHash;
@@ -3542,73 +3602,45 @@ bool GetAssetInfoFromCoin(const Coin& coin, std::string& strName, CAmount& nAmou
 
 bool GetAssetData(const CScript& script, CAssetOutputEntry& data)
 {
-    // Placeholder strings that will get set if you successfully get the transfer or asset from the script
-    std::string address = "";
-    std::string assetName = "";
-
     int nType = 0;
     bool fIsOwner = false;
-    if (!script.IsAssetScript(nType, fIsOwner)) {
+    auto parsed = GetParsedAssetScript(script, nType, fIsOwner);
+    if (!parsed) {
+        return false;
+    }
+
+    if (!parsed->fParsed) {
+        if (nType == TX_TRANSFER_ASSET)
+            LogPrintf("Failed to get transfer from script\n");
         return false;
     }
 
     txnouttype type = txnouttype(nType);
+    data.destination = parsed->destination;
 
-    // Get the New Asset or Transfer Asset from the scriptPubKey
+    // Get the New Asset or Transfer Asset from the parsed scriptPubKey
     if (type == TX_NEW_ASSET && !fIsOwner) {
-        CNewAsset asset;
-        if (AssetFromScript(script, asset, address)) {
-            data.type = TX_NEW_ASSET;
-            data.nAmount = asset.nAmount;
-            data.destination = DecodeDestination(address);
-            data.assetName = asset.strName;
-            return true;
-        } else if (MsgChannelAssetFromScript(script, asset, address)) {
-            data.type = TX_NEW_ASSET;
-            data.nAmount = asset.nAmount;
-            data.destination = DecodeDestination(address);
-            data.assetName = asset.strName;
-        } else if (QualifierAssetFromScript(script, asset, address)) {
-            data.type = TX_NEW_ASSET;
-            data.nAmount = asset.nAmount;
-            data.destination = DecodeDestination(address);
-            data.assetName = asset.strName;
-        } else if (RestrictedAssetFromScript(script, asset, address)) {
-            data.type = TX_NEW_ASSET;
-            data.nAmount = asset.nAmount;
-            data.destination = DecodeDestination(address);
-            data.assetName = asset.strName;
-        }
+        data.type = TX_NEW_ASSET;
+        data.nAmount = parsed->asset.nAmount;
+        data.assetName = parsed->asset.strName;
+        return true;
     } else if (type == TX_TRANSFER_ASSET) {
-        CAssetTransfer transfer;
-        if (TransferAssetFromScript(script, transfer, address)) {
-            data.type = TX_TRANSFER_ASSET;
-            data.nAmount = transfer.nAmount;
-            data.destination = DecodeDestination(address);
-            data.assetName = transfer.strName;
-            data.message = transfer.message;
-            data.expireTime = transfer.nExpireTime;
-            return true;
-        } else {
-            LogPrintf("Failed to get transfer from script\n");
-        }
+        data.type = TX_TRANSFER_ASSET;
+        data.nAmount = parsed->transfer.nAmount;
+        data.assetName = parsed->transfer.strName;
+        data.message = parsed->transfer.message;
+        data.expireTime = parsed->transfer.nExpireTime;
+        return true;
     } else if (type == TX_NEW_ASSET && fIsOwner) {
-        if (OwnerAssetFromScript(script, assetName, address)) {
-            data.type = TX_NEW_ASSET;
-            data.nAmount = OWNER_ASSET_AMOUNT;
-            data.destination = DecodeDestination(address);
-            data.assetName = assetName;
-            return true;
-        }
+        data.type = TX_NEW_ASSET;
+        data.nAmount = OWNER_ASSET_AMOUNT;
+        data.assetName = parsed->strOwnerName;
+        return true;
     } else if (type == TX_REISSUE_ASSET) {
-        CReissueAsset reissue;
-        if (ReissueAssetFromScript(script, reissue, address)) {
-            data.type = TX_REISSUE_ASSET;
-            data.nAmount = reissue.nAmount;
-            data.destination = DecodeDestination(address);
-            data.assetName = reissue.strName;
-            return true;
-        }
+        data.type = TX_REISSUE_ASSET;
+        data.nAmount = parsed->reissue.nAmount;
+        data.assetName = parsed->reissue.strName;
+        return true;
     }
 
     return false;
@@ -3771,6 +3803,14 @@ bool GetBestAssetAddressAmount(CAssetsCache& cache, const std::string& assetName
         if (cache.mapAssetsAddressAmount.count(pair))
             return true;
 
+        // Read through the caches this one is layered on, without changing them
+        for (const CAssetsCache* pbase = cache.GetBase(); pbase; pbase = pbase->GetBase()) {
+            if (pbase->mapAssetsAddressAmount.count(pair)) {
+                cache.mapAssetsAddressAmount[pair] = pbase->mapAssetsAddressAmount.at(pair);
+                return true;
+            }
+        }
+
         // If the caches map has the pair, return true because the map already contains the best dirty amount
         if (passets->mapAssetsAddressAmount.count(pair)) {
             cache.mapAssetsAddressAmount[pair] = passets->mapAssetsAddressAmount.at(pair);
@@ -4263,7 +4303,7 @@ bool CreateReissueAssetTransaction(CWallet* pwallet, CCoinControl& coinControl,
 
 // nullAssetTxData -> Use this for freeze/unfreeze an address or adding a qualifier to an address
 // nullGlobalRestrictionData -> Use this to globally freeze/unfreeze a restricted asset.
-bool CreateTransferAssetTransaction(CWallet* pwallet, const CCoinControl& coinControl, const std::vector< std::pair<CAssetTransfer, std::string> >vTransfers, const std::string& changeAddress, std::pair<int, std::string>& error, CWalletTx& wtxNew, CReserveKey& reservekey, CAmount& nFeeRequired, std::vector<std::pair<CNullAssetTxData, std::string> >* nullAssetTxData, std::vector<CNullAssetTxData>* nullGlobalRestrictionData)
+bool CreateTransferAssetTransaction(CWallet* pwallet, const CCoinControl& coinControl, const std::vector< std::pair<CAssetTransfer, std::string> >vTransfers, const std::string& changeAddress, std::pair<int, std::string>& error, CWalletTx& wtxNew, CReserveKey& reservekey, CAmount& nFeeRequired, std::vector<std::pair<CNullAssetTxData, std::string> >* nullAssetTxData, std::vector<CNullAssetTxData>* nullGlobalRestrictionData, bool sign)
 {
     // Initialize Values for transaction
     std::string strTxError;
@@ -4409,7 +4449,7 @@ bool CreateTransferAssetTransaction(CWallet* pwallet, const CCoinControl& coinCo
     }
 
     // Create and send the transaction
-    if (!pwallet->CreateTransactionWithTransferAsset(vecSend, wtxNew, reservekey, nFeeRequired, nChangePosRet, strTxError, coinControl)) {
+    if (!pwallet->CreateTransactionWithTransferAsset(vecSend, wtxNew, reservekey, nFeeRequired, nChangePosRet, strTxError, coinControl, sign)) {
         if (!fSubtractFeeFromAmount && nFeeRequired > curBalance) {
             error = std::make_pair(RPC_WALLET_ERROR, strprintf("Error: This transaction requires a transaction fee of at least %s", FormatMoney(nFeeRequired)));
             return false;
@@ -4503,7 +4543,7 @@ void GetTxOutAssetTypes(const std::vector<CTxOut>& vout, int& issues, int& reiss
     }
 }
 
-bool ParseAssetScript(CScript scriptPubKey, uint160 &hashBytes, std::string &assetName, CAmount &assetAmount) {
+bool ParseAssetScript(const CScript& scriptPubKey, uint160 &hashBytes, std::string &assetName, CAmount &assetAmount) {
     int nType;
     bool fIsOwner;
     int _nStartingPoint;
@@ -4633,7 +4673,7 @@ void CNullAssetTxVerifierString::ConstructTransaction(CScript &script) const
 
 bool CAssetsCache::GetAssetVerifierStringIfExists(const std::string &name, CNullAssetTxVerifierString& verifierString, bool fSkipTempCache)
 {
-
+    AssertNotLayered();
     /** There are circumstances where a blocks transactions could be changing an assets verifier string, While at the
      * same time a transaction is added to the same block that is trying to transfer the assets who verifier string is
      * changing.
@@ -4701,6 +4741,67 @@ bool CAssetsCache::GetAssetVerifierStringIfExists(const std::string &name, CNull
 }
 
 bool CAssetsCache::CheckForAddressQualifier(const std::string &qualifier_name, const std::string& address, bool fSkipTempCache)
+{
+    AssertNotLayered();
+    bool fHasQualifier;
+    if (CheckForAddressQualifierInMemory(qualifier_name, address, fSkipTempCache, fHasQualifier))
+        return fHasQualifier;
+
+    if (prestricteddb) {
+        // Check for exact qualifier, and add to cache if it exists
+        if (prestricteddb->ReadAddressQualifier(address, qualifier_name)) {
+            CAssetCacheQualifierAddress cachedQualifierAddress(qualifier_name, address, QualifierType::ADD_QUALIFIER);
+            passetsQualifierCache->Put(cachedQualifierAddress.GetHash().GetHex(), 1);
+            return true;
+        }
+
+        // Look for sub qualifiers
+        if (prestricteddb->CheckForAddressRootQualifier(address, qualifier_name)){
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void CAssetsCache::CheckForAddressQualifiers(const std::vector<std::string>& vQualifierNames, const std::string& address, std::vector<bool>& vHasQualifier, bool fSkipTempCache)
+{
+    vHasQualifier.assign(vQualifierNames.size(), false);
+
+    std::vector<size_t> vUndecided;
+    for (size_t i = 0; i < vQualifierNames.size(); i++) {
+        bool fHasQualifier;
+        if (CheckForAddressQualifierInMemory(vQualifierNames[i], address, fSkipTempCache, fHasQualifier))
+            vHasQualifier[i] = fHasQualifier;
+        else
+            vUndecided.push_back(i);
+    }
+
+    if (vUndecided.empty() || !prestricteddb)
+        return;
+
+    // One scan of the qualifiers the database holds for the address answers all of the remaining ones
+    std::vector<std::string> vAddressQualifiers;
+    prestricteddb->ReadAddressQualifiers(address, vAddressQualifiers);
+
+    for (size_t i : vUndecided) {
+        const std::string& qualifier_name = vQualifierNames[i];
+        for (const auto& assigned : vAddressQualifiers) {
+            if (assigned == qualifier_name) {
+                CAssetCacheQualifierAddress cachedQualifierAddress(qualifier_name, address, QualifierType::ADD_QUALIFIER);
+                passetsQualifierCache->Put(cachedQualifierAddress.GetHash().GetHex(), 1);
+                vHasQualifier[i] = true;
+                break;
+            }
+
+            // Sub qualifiers count for their root
+            if (assigned.rfind(std::string(qualifier_name + "/"), 0) == 0)
+                vHasQualifier[i] = true;
+        }
+    }
+}
+
+bool CAssetsCache::CheckForAddressQualifierInMemory(const std::string &qualifier_name, const std::string& address, bool fSkipTempCache, bool& fHasQualifier)
 {
     /** There are circumstances where a blocks transactions could be removing or adding a qualifier to an address,
      * While at the same time a transaction is added to the same block that is trying to transfer to the same address.
@@ -4718,27 +4819,31 @@ bool CAssetsCache::CheckForAddressQualifier(const std::string &qualifier_name, c
     auto setIterator = setNewQualifierAddressToRemove.find(cachedQualifierAddress);
     if (!fSkipTempCache &&setIterator != setNewQualifierAddressToRemove.end()) {
         // Undoing a remove qualifier command, means that we are adding the qualifier to the address
-        return setIterator->type == QualifierType::REMOVE_QUALIFIER;
+        fHasQualifier = setIterator->type == QualifierType::REMOVE_QUALIFIER;
+        return true;
     }
 
 
     setIterator = passets->setNewQualifierAddressToRemove.find(cachedQualifierAddress);
     if (setIterator != passets->setNewQualifierAddressToRemove.end()) {
         // Undoing a remove qualifier command, means that we are adding the qualifier to the address
-        return setIterator->type == QualifierType::REMOVE_QUALIFIER;
+        fHasQualifier = setIterator->type == QualifierType::REMOVE_QUALIFIER;
+        return true;
     }
 
     setIterator = setNewQualifierAddressToAdd.find(cachedQualifierAddress);
     if (!fSkipTempCache && setIterator != setNewQualifierAddressToAdd.end()) {
         // Return true if we are adding the qualifier, and false if we are removing it
-        return setIterator->type == QualifierType::ADD_QUALIFIER;
+        fHasQualifier = setIterator->type == QualifierType::ADD_QUALIFIER;
+        return true;
     }
 
 
     setIterator = passets->setNewQualifierAddressToAdd.find(cachedQualifierAddress);
     if (setIterator != passets->setNewQualifierAddressToAdd.end()) {
+        fHasQualifier = false;
         if (setIterator->type == QualifierType::ADD_QUALIFIER) {
-            return true;
+            fHasQualifier = true;
         } else {
             // BUG FIX:
             // This scenario can occur if a tag #TAG is removed from an address in a block, then in a later block
@@ -4750,43 +4855,32 @@ bool CAssetsCache::CheckForAddressQualifier(const std::string &qualifier_name, c
             auto tempChecker = CAssetCacheRootQualifierChecker(qualifier_name, address);
             if (passets->mapRootQualifierAddressesAdd.count(tempChecker)) {
                 if (passets->mapRootQualifierAddressesAdd.at(tempChecker).size()) {
-                    return true;
+                    fHasQualifier = true;
                 }
             }
-
-            return false;
         }
+        return true;
     }
 
     auto tempChecker = CAssetCacheRootQualifierChecker(qualifier_name, address);
     if (!fSkipTempCache && mapRootQualifierAddressesAdd.count(tempChecker)){
         if (mapRootQualifierAddressesAdd.at(tempChecker).size()) {
+            fHasQualifier = true;
             return true;
         }
     }
 
     if (passets->mapRootQualifierAddressesAdd.count(tempChecker)) {
         if (passets->mapRootQualifierAddressesAdd.at(tempChecker).size()) {
+            fHasQualifier = true;
             return true;
         }
     }
 
-    // Check the cache, if it doesn't exist in the cache. Try and read it from database
+    // Check the cache, if it doesn't exist in the cache. The database has to be read
     if (passetsQualifierCache) {
         if (passetsQualifierCache->Exists(cachedQualifierAddress.GetHash().GetHex())) {
-            return true;
-        }
-    }
-
-    if (prestricteddb) {
-        // Check for exact qualifier, and add to cache if it exists
-        if (prestricteddb->ReadAddressQualifier(address, qualifier_name)) {
-            passetsQualifierCache->Put(cachedQualifierAddress.GetHash().GetHex(), 1);
-            return true;
-        }
-
-        // Look for sub qualifiers
-        if (prestricteddb->CheckForAddressRootQualifier(address, qualifier_name)){
+            fHasQualifier = true;
             return true;
         }
     }
@@ -4797,6 +4891,7 @@ bool CAssetsCache::CheckForAddressQualifier(const std::string &qualifier_name, c
 
 bool CAssetsCache::CheckForAddressRestriction(const std::string &restricted_name, const std::string& address, bool fSkipTempCache)
 {
+    AssertNotLayered();
     /** There are circumstances where a blocks transactions could be removing or adding a restriction to an address,
      * While at the same time a transaction is added to the same block that is trying to transfer from that address.
      * Depending on the ordering of these two transactions. The address restriction database used to verify the validity of the
@@ -4855,6 +4950,7 @@ bool CAssetsCache::CheckForAddressRestriction(const std::string &restricted_name
 
 bool CAssetsCache::CheckForGlobalRestriction(const std::string &restricted_name, bool fSkipTempCache)
 {
+    AssertNotLayered();
     /** There are circumstances where a blocks transactions could be freezing all asset transfers. While at
      * the same time a transaction is added to the same block that is trying to transfer the same asset that is being
      * frozen.
@@ -5203,20 +5299,70 @@ bool ContextualCheckVerifierAssetTxOut(const CTxOut& txout, CAssetsCache* assetC
     return true;
 }
 
+/** A verifier string that passed CheckVerifierString, compiled for evaluation against addresses */
+struct CCompiledVerifier
+{
+    std::vector<std::string> vQualifiers; //! The qualifiers it uses, with their '#'
+    LibBoolEE::Program program;           //! Refers to the qualifiers by their index in vQualifiers
+};
+
+static CCriticalSection cs_compiledVerifiers;
+static std::unordered_map<std::string, std::shared_ptr<const CCompiledVerifier>> mapCompiledVerifiers;
+static const size_t MAX_COMPILED_VERIFIERS = 10000;
+
+/** Returns the compiled form of the verifier string, or nullptr if it fails CheckVerifierString.
+ * Compilations are keyed by the verifier text, so a reissue that changes an asset's verifier simply uses another entry. */
+static std::shared_ptr<const CCompiledVerifier> GetCompiledVerifier(const std::string& verifier)
+{
+    {
+        LOCK(cs_compiledVerifiers);
+        auto it = mapCompiledVerifiers.find(verifier);
+        if (it != mapCompiledVerifiers.end())
+            return it->second;
+    }
+
+    std::set<std::string> setFoundQualifiers;
+    std::string strError;
+    if (!CheckVerifierString(verifier, setFoundQualifiers, strError))
+        return nullptr;
+
+    auto compiled = std::make_shared<CCompiledVerifier>();
+    std::vector<std::string> vVariables(setFoundQualifiers.begin(), setFoundQualifiers.end());
+    for (const auto& qualifier : vVariables)
+        compiled->vQualifiers.emplace_back(QUALIFIER_CHAR + qualifier);
+
+    try {
+        compiled->program = LibBoolEE::compile(verifier, vVariables);
+    } catch (const std::runtime_error& run_error) {
+        return nullptr;
+    }
+
+    LOCK(cs_compiledVerifiers);
+    if (mapCompiledVerifiers.size() >= MAX_COMPILED_VERIFIERS)
+        mapCompiledVerifiers.clear();
+    mapCompiledVerifiers.emplace(verifier, compiled);
+    return compiled;
+}
+
 bool ContextualCheckVerifierString(CAssetsCache* cache, const std::string& verifier, const std::string& check_address, std::string& strError, ErrorReport* errorReport)
 {
     // If verifier is set to true, return true
     if (verifier == "true")
         return true;
 
-    // Check against the non contextual changes first
-    std::set<std::string> setFoundQualifiers;
-    if (!CheckVerifierString(verifier, setFoundQualifiers, strError, errorReport))
-        return false;
+    // Check against the non contextual changes first, rerunning the check on failure to report the error
+    auto compiled = GetCompiledVerifier(verifier);
+    if (!compiled) {
+        std::set<std::string> setFoundQualifiers;
+        if (!CheckVerifierString(verifier, setFoundQualifiers, strError, errorReport))
+            return false;
+
+        strError = "bad-txns-null-verifier-failed-contexual-syntax-check";
+        return error("%s : Verifier string failed to compile: %s\n", __func__, verifier);
+    }
 
     // Loop through each qualifier and make sure that the asset exists
-    for(auto qualifier : setFoundQualifiers) {
-        std::string search = QUALIFIER_CHAR + qualifier;
+    for (const auto& search : compiled->vQualifiers) {
         if (!cache->CheckIfAssetExists(search, true)) {
             if (errorReport) {
                 errorReport->type = ErrorReport::ErrorType::AssetDoesntExist;
@@ -5233,50 +5379,24 @@ bool ContextualCheckVerifierString(CAssetsCache* cache, const std::string& verif
     if (check_address.empty())
         return true;
 
-    // Create an object that stores if an address contains a qualifier
-    LibBoolEE::Vals vals;
-
-    // Add the qualifiers into the vals object
-    for (auto qualifier : setFoundQualifiers) {
-        std::string search = QUALIFIER_CHAR + qualifier;
-
-        // Check to see if the address contains the qualifier
-        bool has_qualifier = cache->CheckForAddressQualifier(search, check_address, true);
-
-        // Add the true or false value into the vals
-        vals.insert(std::make_pair(qualifier, has_qualifier));
-    }
-
-    try {
-        bool ret = LibBoolEE::resolve(verifier, vals, errorReport);
-        if (!ret) {
-            if (errorReport) {
-                if (errorReport->type == ErrorReport::ErrorType::NotSetError) {
-                    errorReport->type = ErrorReport::ErrorType::FailedToVerifyAgainstAddress;
-                    errorReport->vecUserData.emplace_back(check_address);
-                    errorReport->strDevData = "bad-txns-null-verifier-address-failed-verification";
-                }
-            }
-
-            error("%s : The address %s failed to verify against: %s. Is null %d", __func__, check_address, verifier, errorReport ? 0 : 1);
-            strError = "bad-txns-null-verifier-address-failed-verification";
-        }
-        return ret;
-
-    } catch (const std::runtime_error& run_error) {
+    // Check which of the qualifiers the address has, all at once
+    std::vector<bool> vHasQualifier;
+    cache->CheckForAddressQualifiers(compiled->vQualifiers, check_address, vHasQualifier, true);
 
+    bool ret = LibBoolEE::evaluate(compiled->program, vHasQualifier);
+    if (!ret) {
         if (errorReport) {
             if (errorReport->type == ErrorReport::ErrorType::NotSetError) {
-                errorReport->type = ErrorReport::ErrorType::InvalidSyntax;
+                errorReport->type = ErrorReport::ErrorType::FailedToVerifyAgainstAddress;
+                errorReport->vecUserData.emplace_back(check_address);
+                errorReport->strDevData = "bad-txns-null-verifier-address-failed-verification";
             }
-
-            errorReport->vecUserData.emplace_back(run_error.what());
-            errorReport->strDevData = "bad-txns-null-verifier-failed-contexual-syntax-check";
         }
 
-        strError = "bad-txns-null-verifier-failed-contexual-syntax-check";
-        return error("%s : Verifier string failed to resolve. Please check string syntax - exception: %s\n", __func__, run_error.what());
+        error("%s : The address %s failed to verify against: %s. Is null %d", __func__, check_address, verifier, errorReport ? 0 : 1);
+        strError = "bad-txns-null-verifier-address-failed-verification";
     }
+    return ret;
 }
 
 bool ContextualCheckTransferAsset(CAssetsCache* assetCache, const CAssetTransfer& transfer, const std::string& address, std::string& strError)
@@ -11,10 +11,12 @@
 #include "tinyformat.h"
 #include "assettypes.h"
 
+#include <assert.h>
 #include <string>
 #include <set>
 #include <map>
 #include <unordered_map>
+#include <unordered_set>
 #include <list>
 
 #define AVN_R 114
@@ -69,6 +71,9 @@ class COutput;
 // 2500 * 82 Bytes == 205 KB (kilobytes) of memory
 #define MAX_CACHE_ASSETS_SIZE 2500
 
+// Parsed asset scripts kept by script hash, each a few hundred bytes
+#define MAX_PARSED_ASSET_SCRIPTS 20000
+
 // Create map that store that state of current reissued transaction that the mempool as accepted.
 // If an asset name is in this map, any other reissue transactions wont be accepted into the mempool
 extern std::map<uint256, std::string> mapReissuedTx;
@@ -76,7 +81,7 @@ extern std::map<std::string, uint256> mapReissuedAssets;
 
 class CAssets {
 public:
-    std::map<std::pair<std::string, std::string>, CAmount> mapAssetsAddressAmount; // pair < Asset Name , Address > -> Quantity of tokens in the address
+    std::unordered_map<std::pair<std::string, std::string>, CAmount, CAssetAddressHasher> mapAssetsAddressAmount; // pair < Asset Name , Address > -> Quantity of tokens in the address
 
     // Dirty, Gets wiped once flushed to database
     std::map<std::string, CNewAsset> mapReissuedAssetData; // Asset Name -> New Asset Data
@@ -129,9 +134,18 @@ std::string GetUserErrorString(const ErrorReport& report);
 class CAssetsCache : public CAssets
 {
 private:
+    //! Cache this one is layered on top of, nullptr when it sits directly on top of passets
+    CAssetsCache* pbase;
+
+    //! Only the address amounts read through pbase, every other lookup falls back to passets directly
+    void AssertNotLayered() const { assert(!pbase); }
+
     bool AddBackSpentAsset(const Coin& coin, const std::string& assetName, const std::string& address, const CAmount& nAmount, const COutPoint& out);
     void AddToAssetBalance(const std::string& strName, const std::string& address, const CAmount& nAmount);
     bool UndoTransfer(const CAssetTransfer& transfer, const std::string& address, const COutPoint& outToRemove);
+
+    //! Returns true if the caches know whether the address has the qualifier, which is then set in fHasQualifier
+    bool CheckForAddressQualifierInMemory(const std::string &qualifier_name, const std::string& address, bool fSkipTempCache, bool& fHasQualifier);
 public :
     //! These are memory only containers that show dirty entries that will be databased when flushed
     std::vector<CAssetCacheUndoAssetAmount> vUndoAssetAmount;
@@ -150,8 +164,8 @@ public :
     std::set<CAssetCacheNewOwner> setNewOwnerAssetsToRemove;
 
     //! Transfer Assets Caches
-    std::set<CAssetCacheNewTransfer> setNewTransferAssetsToAdd;
-    std::set<CAssetCacheNewTransfer> setNewTransferAssetsToRemove;
+    std::unordered_set<CAssetCacheNewTransfer, CAssetCacheNewTransferHasher> setNewTransferAssetsToAdd;
+    std::unordered_set<CAssetCacheNewTransfer, CAssetCacheNewTransferHasher> setNewTransferAssetsToRemove;
 
     //! Qualfier Address Asset Caches
     std::set<CAssetCacheQualifierAddress> setNewQualifierAddressToAdd;
@@ -173,13 +187,19 @@ public :
     std::map<CAssetCacheRootQualifierChecker, std::set<std::string> > mapRootQualifierAddressesAdd;
     std::map<CAssetCacheRootQualifierChecker, std::set<std::string> > mapRootQualifierAddressesRemove;
 
-    CAssetsCache() : CAssets()
+    CAssetsCache() : CAssets(), pbase(nullptr)
     {
         SetNull();
         ClearDirtyCache();
     }
 
-    CAssetsCache(const CAssetsCache& cache) : CAssets(cache)
+    /** Create an empty cache layered on top of baseIn (passets when nullptr). Nothing is copied up
+     * front. When baseIn isn't passets, only the address amounts read through it, so such a cache may
+     * only spend coins (as DisconnectBlock's scratch cache does). Asset, metadata, verifier, qualifier
+     * and restriction lookups on it assert. Only a cache directly on top of passets can be flushed. */
+    explicit CAssetsCache(CAssetsCache* baseIn);
+
+    CAssetsCache(const CAssetsCache& cache) : CAssets(cache), pbase(cache.pbase)
     {
         //! Copy dirty cache also
         this->vSpentAssets = cache.vSpentAssets;
@@ -224,6 +244,7 @@ public :
 
     CAssetsCache& operator=(const CAssetsCache& cache)
     {
+        this->pbase = cache.pbase;
         this->mapAssetsAddressAmount = cache.mapAssetsAddressAmount;
         this->mapReissuedAssetData = cache.mapReissuedAssetData;
 
@@ -270,6 +291,9 @@ public :
         return *this;
     }
 
+    //! The cache this one is layered on top of, nullptr when that is passets
+    CAssetsCache* GetBase() const { return pbase; }
+
     //! Cache only undo functions
     bool RemoveNewAsset(const CNewAsset& asset, const std::string address);
     bool RemoveTransfer(const CAssetTransfer& transfer, const std::string& address, const COutPoint& out);
@@ -311,6 +335,9 @@ public :
     //! Return true if the address has the given qualifier assigned to it
     bool CheckForAddressQualifier(const std::string &qualifier_name, const std::string& address, bool fSkipTempCache = false);
 
+    //! Same as CheckForAddressQualifier for each of the qualifiers, reading the address's qualifiers from the database at most once
+    void CheckForAddressQualifiers(const std::vector<std::string>& vQualifierNames, const std::string& address, std::vector<bool>& vHasQualifier, bool fSkipTempCache = false);
+
     //! Return true if the address is marked as frozen
     bool CheckForAddressRestriction(const std::string &restricted_name, const std::string& address, bool fSkipTempCache = false);
 
@@ -320,6 +347,9 @@ public :
     //! Calculate the size of the CAssets (in bytes)
     size_t DynamicMemoryUsage() const;
 
+    //! The part of DynamicMemoryUsage() held by the dirty entries waiting to be databased
+    size_t DirtyMemoryUsage() const;
+
     //! Get the size of the none databased cache
     size_t GetCacheSize() const;
     size_t GetCacheSizeV2() const;
@@ -445,6 +475,9 @@ bool MsgChannelAssetFromTransaction(const CTransaction& tx, CNewAsset& asset, st
 bool QualifierAssetFromTransaction(const CTransaction& tx, CNewAsset& asset, std::string& strAddress);
 bool RestrictedAssetFromTransaction(const CTransaction& tx, CNewAsset& asset, std::string& strAddress);
 
+//! Number of asset scripts in the parsed asset script cache
+size_t GetParsedAssetScriptsCacheSize();
+
 //! Get specific asset type metadata from the given scripts
 bool TransferAssetFromScript(const CScript& scriptPubKey, CAssetTransfer& assetTransfer, std::string& strAddress);
 bool AssetFromScript(const CScript& scriptPubKey, CNewAsset& asset, std::string& strAddress);
@@ -542,7 +575,7 @@ bool CreateReissueAssetTransaction(CWallet* pwallet, CCoinControl& coinControl,
 
 
 //! Create a transfer asset transaction
-bool CreateTransferAssetTransaction(CWallet* pwallet, const CCoinControl& coinControl, const std::vector< std::pair<CAssetTransfer, std::string> >vTransfers, const std::string& changeAddress, std::pair<int, std::string>& error, CWalletTx& wtxNew, CReserveKey& reservekey, CAmount& nFeeRequired, std::vector<std::pair<CNullAssetTxData, std::string> >* nullAssetTxData = nullptr, std::vector<CNullAssetTxData>* nullGlobalRestrictionData = nullptr);
+bool CreateTransferAssetTransaction(CWallet* pwallet, const CCoinControl& coinControl, const std::vector< std::pair<CAssetTransfer, std::string> >vTransfers, const std::string& changeAddress, std::pair<int, std::string>& error, CWalletTx& wtxNew, CReserveKey& reservekey, CAmount& nFeeRequired, std::vector<std::pair<CNullAssetTxData, std::string> >* nullAssetTxData = nullptr, std::vector<CNullAssetTxData>* nullGlobalRestrictionData = nullptr, bool sign = true);
 
 //! Send any type of asset transaction to the network
 bool SendAssetTransaction(CWallet* pwallet, CWalletTx& transaction, CReserveKey& reserveKey, std::pair<int, std::string>& error, std::string& txid);
@@ -552,7 +585,7 @@ bool VerifyWalletHasAsset(const std::string& asset_name, std::pair<int, std::str
 #endif
 
 /** Helper method for extracting address bytes, asset name and amount from an asset script */
-bool ParseAssetScript(CScript scriptPubKey, uint160 &hashBytes, std::string &assetName, CAmount &assetAmount);
+bool ParseAssetScript(const CScript& scriptPubKey, uint160 &hashBytes, std::string &assetName, CAmount &assetAmount);
 
 /** Helper method for extracting #TAGS from a verifier string */
 void ExtractVerifierStringQualifiers(const std::string& verifier, std::set<std::string>& qualifiers);
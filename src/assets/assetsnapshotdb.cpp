@@ -5,11 +5,33 @@
 #include "assetsnapshotdb.h"
 #include "validation.h"
 #include "base58.h"
+#include "hash.h"
 
 #include <boost/algorithm/string.hpp>
 #include <boost/thread.hpp>
 
-static const char SNAPSHOTCHECK_FLAG = 'C'; // Snapshot Check
+static const char SNAPSHOTCHECK_FLAG = 'C'; // Snapshot Check, a whole snapshot in one entry
+static const char SNAPSHOT_HEADER_FLAG = 'H'; // Snapshot Header, the chunks of a snapshot
+static const char SNAPSHOT_CHUNK_FLAG = 'K'; // Snapshot Chunk, a run of owners shared between snapshots
+static const char SNAPSHOT_CHUNK_REFS_FLAG = 'R'; // Snapshot Chunk References, the number of snapshots using a chunk
+
+//  Owners close a chunk when the hash of their address says so, about one in this many. As the
+//      boundaries don't depend on the other owners, later snapshots of the same asset store only
+//      the chunks around the holders that changed and reference the rest.
+static const uint64_t SNAPSHOT_CHUNK_AVERAGE_SIZE = 256;
+
+//  Chunks are closed at this size no matter what, to bound the memory used while snapshotting
+static const size_t MAX_SNAPSHOT_CHUNK_SIZE = 4096;
+
+//  New chunks are written ahead of the snapshot once this many bytes of them are pending
+static const size_t SNAPSHOT_CHUNK_BATCH_SIZE = 16 << 20;
+
+static bool IsSnapshotChunkEnd(const std::string & p_address)
+{
+    //  Fixed keys, the boundaries must be the same for every snapshot
+    uint64_t hash = CSipHasher(0, 0).Write((const unsigned char*)p_address.data(), p_address.size()).Finalize();
+    return hash % SNAPSHOT_CHUNK_AVERAGE_SIZE == 0;
+}
 
 CAssetSnapshotDBEntry::CAssetSnapshotDBEntry()
 {
@@ -47,63 +69,105 @@ bool CAssetSnapshotDB::AddAssetOwnershipSnapshot(
         return false;
     }
 
-    std::set<std::pair<std::string, CAmount>> ownersAndAmounts;
+    //  The references of every chunk change in one batch together with the header, so a snapshot is
+    //      either stored whole or not at all. Chunk contents aren't visible before something references
+    //      them, the new ones are written ahead in batches of their own to bound the memory used.
+    CDBBatch batch(*this);
+    CDBBatch chunkBatch(*this);
+    std::map<uint256, int> mapRefChanges;
+    std::set<uint256> setNewChunks;
+
+    //  A snapshot at this height may exist from before a reorg, replace it
+    std::string heightAndName = std::to_string(p_height) + p_assetName;
+    ReleaseSnapshot(heightAndName, batch, mapRefChanges);
+
+    CAssetSnapshotDBHeader header;
+    header.height = p_height;
+    header.assetName = p_assetName;
+
+    std::vector<std::pair<std::string, CAmount>> chunkOwnersAndAmounts;
     std::vector<std::pair<std::string, CAmount>> tempOwnersAndAmounts;
-    int totalEntryCount;
 
-    if (!passetsdb->AssetAddressDir(tempOwnersAndAmounts, totalEntryCount, true, p_assetName, INT_MAX, 0)) {
-        LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: Failed to retrieve assets directory for '%s'\n", p_assetName.c_str());
-        return false;
-    }
+    //  Make sure the database reflects the chain state once, then page through it
+    FlushStateToDisk();
 
-    //  Retrieve all of the addresses/amounts in batches
-    const int MAX_RETRIEVAL_COUNT = 100;
+    //  Retrieve all of the addresses/amounts in batches, each one continuing where the last one stopped.
+    //      Every owner is read, only the chunks around the owners that changed since an earlier snapshot
+    //      of the asset are written.
+    const int MAX_RETRIEVAL_COUNT = 1000;
     bool errorsOccurred = false;
+    std::string strAfterAddress;
+
+    auto addChunk = [&]() {
+        uint256 chunkHash = AddSnapshotChunk(chunkOwnersAndAmounts, chunkBatch, setNewChunks);
+        mapRefChanges[chunkHash] += 1;
+        header.vChunks.push_back(chunkHash);
+        chunkOwnersAndAmounts.clear();
+
+        if (chunkBatch.SizeEstimate() > SNAPSHOT_CHUNK_BATCH_SIZE) {
+            if (!WriteBatch(chunkBatch))
+                return false;
+            chunkBatch.Clear();
+        }
+        return true;
+    };
 
-    for (int retrievalOffset = 0; retrievalOffset < totalEntryCount; retrievalOffset += MAX_RETRIEVAL_COUNT) {
-        //  Retrieve the specified segment of addresses
-        if (!passetsdb->AssetAddressDir(tempOwnersAndAmounts, totalEntryCount, false, p_assetName, MAX_RETRIEVAL_COUNT, retrievalOffset)) {
+    do {
+        std::string strNextAddress;
+        if (!passetsdb->AssetAddressDirFrom(tempOwnersAndAmounts, p_assetName, strAfterAddress, MAX_RETRIEVAL_COUNT, strNextAddress)) {
             LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: Failed to retrieve assets directory for '%s'\n", p_assetName.c_str());
             errorsOccurred = true;
             break;
         }
+        strAfterAddress = strNextAddress;
 
-        //  Verify that some addresses were returned
-        if (tempOwnersAndAmounts.size() == 0) {
-            LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: No addresses were retrieved.\n");
-            continue;
-        }
-
-        //  Move these into the main set
+        //  Move these into the current chunk, storing it when an owner ends it
         for (auto const & currPair : tempOwnersAndAmounts) {
             //  Verify that the address is valid
             CTxDestination dest = DecodeDestination(currPair.first);
-            if (IsValidDestination(dest)) {
-                ownersAndAmounts.insert(currPair);
-            }
-            else {
+            if (!IsValidDestination(dest)) {
                 LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: Address '%s' is invalid.\n", currPair.first.c_str());
+                continue;
+            }
+
+            chunkOwnersAndAmounts.push_back(currPair);
+            header.nOwnerCount += 1;
+
+            if (IsSnapshotChunkEnd(currPair.first) || chunkOwnersAndAmounts.size() >= MAX_SNAPSHOT_CHUNK_SIZE) {
+                if (!addChunk()) {
+                    errorsOccurred = true;
+                    break;
+                }
             }
         }
 
         tempOwnersAndAmounts.clear();
-    }
+    } while (!errorsOccurred && !strAfterAddress.empty());
 
-    if (errorsOccurred) {
-        LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: Errors occurred while acquiring ownership info for asset '%s'.\n", p_assetName.c_str());
-        return false;
-    }
-    if (ownersAndAmounts.size() == 0) {
-        LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: No owners exist for asset '%s'.\n", p_assetName.c_str());
+    if (!errorsOccurred && !chunkOwnersAndAmounts.empty())
+        errorsOccurred = !addChunk();
+
+    if (errorsOccurred || header.nOwnerCount == 0) {
+        if (errorsOccurred)
+            LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: Errors occurred while acquiring ownership info for asset '%s'.\n", p_assetName.c_str());
+        else
+            LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: No owners exist for asset '%s'.\n", p_assetName.c_str());
+
+        //  Nothing references the chunks written ahead, don't leave them behind
+        CDBBatch eraseBatch(*this);
+        for (auto const & chunkHash : setNewChunks)
+            eraseBatch.Erase(std::make_pair(SNAPSHOT_CHUNK_FLAG, chunkHash));
+        WriteBatch(eraseBatch);
         return false;
     }
 
-    //  Write the snapshot to the database. We don't care if we overwrite, because it should be identical.
-    CAssetSnapshotDBEntry snapshotEntry(p_assetName, p_height, ownersAndAmounts);
+    WriteChunkRefChanges(mapRefChanges, batch);
+    batch.Write(std::make_pair(SNAPSHOT_HEADER_FLAG, heightAndName), header);
 
-    if (Write(std::make_pair(SNAPSHOTCHECK_FLAG, snapshotEntry.heightAndName), snapshotEntry)) {
-        LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: Successfully added snapshot for '%s' at height %d (ownerCount = %d).\n",
-            p_assetName.c_str(), p_height, ownersAndAmounts.size());
+    //  The chunks first, so that the header never references a missing one
+    if (WriteBatch(chunkBatch) && WriteBatch(batch)) {
+        LogPrint(BCLog::REWARDS, "AddAssetOwnershipSnapshot: Successfully added snapshot for '%s' at height %d (ownerCount = %d, chunkCount = %d).\n",
+            p_assetName.c_str(), p_height, header.nOwnerCount, header.vChunks.size());
         return true;
     }
     return false;
@@ -112,6 +176,23 @@ bool CAssetSnapshotDB::AddAssetOwnershipSnapshot(
 bool CAssetSnapshotDB::RetrieveOwnershipSnapshot(
     const std::string & p_assetName, int p_height,
     CAssetSnapshotDBEntry & p_snapshotEntry)
+{
+    std::set<std::pair<std::string, CAmount>> ownersAndAmounts;
+    bool succeeded = ForEachOwnerInSnapshot(p_assetName, p_height,
+        [&ownersAndAmounts](const std::string & p_address, CAmount p_amount) {
+            ownersAndAmounts.insert(std::make_pair(p_address, p_amount));
+            return true;
+        });
+
+    if (succeeded)
+        p_snapshotEntry = CAssetSnapshotDBEntry(p_assetName, p_height, ownersAndAmounts);
+
+    return succeeded;
+}
+
+bool CAssetSnapshotDB::ForEachOwnerInSnapshot(
+    const std::string & p_assetName, int p_height,
+    const std::function<bool(const std::string &, CAmount)> & p_func)
 {
     //  Load up the snapshot entries at this height
     std::string heightAndName = std::to_string(p_height) + p_assetName;
@@ -120,7 +201,41 @@ bool CAssetSnapshotDB::RetrieveOwnershipSnapshot(
         __func__,
         heightAndName.c_str());
 
-    bool succeeded = Read(std::make_pair(SNAPSHOTCHECK_FLAG, heightAndName), p_snapshotEntry);
+    bool succeeded = false;
+    CAssetSnapshotDBHeader header;
+    if (Read(std::make_pair(SNAPSHOT_HEADER_FLAG, heightAndName), header)) {
+        succeeded = true;
+        for (auto const & chunkHash : header.vChunks) {
+            boost::this_thread::interruption_point();
+
+            CAssetSnapshotDBChunk chunk;
+            if (!Read(std::make_pair(SNAPSHOT_CHUNK_FLAG, chunkHash), chunk)) {
+                LogPrint(BCLog::REWARDS, "%s : Missing chunk %s of snapshot '%s'\n", __func__, chunkHash.GetHex(), heightAndName.c_str());
+                succeeded = false;
+                break;
+            }
+            for (auto const & currPair : chunk.vOwnersAndAmounts) {
+                if (!p_func(currPair.first, currPair.second)) {
+                    succeeded = false;
+                    break;
+                }
+            }
+            if (!succeeded)
+                break;
+        }
+    } else {
+        //  Snapshots taken before they were stored in chunks
+        CAssetSnapshotDBEntry snapshotEntry;
+        if (Read(std::make_pair(SNAPSHOTCHECK_FLAG, heightAndName), snapshotEntry)) {
+            succeeded = true;
+            for (auto const & currPair : snapshotEntry.ownersAndAmounts) {
+                if (!p_func(currPair.first, currPair.second)) {
+                    succeeded = false;
+                    break;
+                }
+            }
+        }
+    }
 
     LogPrint(BCLog::REWARDS, "%s : Retrieval of snapshot for '%s' %s!\n",
         __func__,
@@ -130,6 +245,13 @@ bool CAssetSnapshotDB::RetrieveOwnershipSnapshot(
     return succeeded;
 }
 
+bool CAssetSnapshotDB::ContainsOwnershipSnapshot(
+    const std::string & p_assetName, int p_height)
+{
+    std::string heightAndName = std::to_string(p_height) + p_assetName;
+    return Exists(std::make_pair(SNAPSHOT_HEADER_FLAG, heightAndName)) || Exists(std::make_pair(SNAPSHOTCHECK_FLAG, heightAndName));
+}
+
 bool CAssetSnapshotDB::RemoveOwnershipSnapshot(
     const std::string & p_assetName, int p_height)
 {
@@ -140,7 +262,12 @@ bool CAssetSnapshotDB::RemoveOwnershipSnapshot(
         __func__,
         heightAndName.c_str());
 
-    bool succeeded = Erase(std::make_pair(SNAPSHOTCHECK_FLAG, heightAndName), true);
+    //  The header and the references to its chunks go at once
+    CDBBatch batch(*this);
+    std::map<uint256, int> mapRefChanges;
+    ReleaseSnapshot(heightAndName, batch, mapRefChanges);
+    WriteChunkRefChanges(mapRefChanges, batch);
+    bool succeeded = WriteBatch(batch);
 
     LogPrint(BCLog::REWARDS, "%s : Removal of snapshot for '%s' %s!\n",
         __func__,
@@ -149,3 +276,48 @@ bool CAssetSnapshotDB::RemoveOwnershipSnapshot(
 
     return succeeded;
 }
+
+void CAssetSnapshotDB::ReleaseSnapshot(const std::string & p_heightAndName, CDBBatch & p_batch, std::map<uint256, int> & p_refChanges)
+{
+    CAssetSnapshotDBHeader header;
+    if (Read(std::make_pair(SNAPSHOT_HEADER_FLAG, p_heightAndName), header)) {
+        for (auto const & chunkHash : header.vChunks)
+            p_refChanges[chunkHash] -= 1;
+        p_batch.Erase(std::make_pair(SNAPSHOT_HEADER_FLAG, p_heightAndName));
+    }
+    p_batch.Erase(std::make_pair(SNAPSHOTCHECK_FLAG, p_heightAndName));
+}
+
+uint256 CAssetSnapshotDB::AddSnapshotChunk(const std::vector<std::pair<std::string, CAmount>> & p_ownersAndAmounts, CDBBatch & p_batch, std::set<uint256> & p_newChunks)
+{
+    CHashWriter ss(SER_GETHASH, PROTOCOL_VERSION);
+    ss << p_ownersAndAmounts;
+    uint256 chunkHash = ss.GetHash();
+
+    if (!p_newChunks.count(chunkHash) && !Exists(std::make_pair(SNAPSHOT_CHUNK_FLAG, chunkHash))) {
+        CAssetSnapshotDBChunk chunk;
+        chunk.vOwnersAndAmounts = p_ownersAndAmounts;
+        p_batch.Write(std::make_pair(SNAPSHOT_CHUNK_FLAG, chunkHash), chunk);
+        p_newChunks.insert(chunkHash);
+    }
+    return chunkHash;
+}
+
+void CAssetSnapshotDB::WriteChunkRefChanges(const std::map<uint256, int> & p_refChanges, CDBBatch & p_batch)
+{
+    for (auto const & change : p_refChanges) {
+        if (change.second == 0)
+            continue;
+
+        int nRefCount = 0;
+        Read(std::make_pair(SNAPSHOT_CHUNK_REFS_FLAG, change.first), nRefCount);
+        nRefCount += change.second;
+
+        if (nRefCount <= 0) {
+            p_batch.Erase(std::make_pair(SNAPSHOT_CHUNK_REFS_FLAG, change.first));
+            p_batch.Erase(std::make_pair(SNAPSHOT_CHUNK_FLAG, change.first));
+        } else {
+            p_batch.Write(std::make_pair(SNAPSHOT_CHUNK_REFS_FLAG, change.first), nRefCount);
+        }
+    }
+}
@@ -5,10 +5,14 @@
 #ifndef ASSETSNAPSHOTDB_H
 #define ASSETSNAPSHOTDB_H
 
+#include <functional>
+#include <map>
 #include <set>
+#include <vector>
 
 #include <dbwrapper.h>
 #include "amount.h"
+#include "uint256.h"
 
 class CAssetSnapshotDBEntry
 {
@@ -53,6 +57,68 @@ public:
     }
 };
 
+/** Index of a snapshot stored in chunks: the owner count and the chunks holding the owners, in assets database order */
+class CAssetSnapshotDBHeader
+{
+public:
+    int height;
+    std::string assetName;
+    uint64_t nOwnerCount;
+    std::vector<uint256> vChunks;
+
+    CAssetSnapshotDBHeader()
+    {
+        SetNull();
+    }
+
+    void SetNull()
+    {
+        height = 0;
+        assetName = "";
+        nOwnerCount = 0;
+        vChunks.clear();
+    }
+
+    // Serialization methods
+    ADD_SERIALIZE_METHODS;
+
+    template<typename Stream, typename Operation>
+    inline void SerializationOp(Stream &s, Operation ser_action)
+    {
+        READWRITE(height);
+        READWRITE(assetName);
+        READWRITE(nOwnerCount);
+        READWRITE(vChunks);
+    }
+};
+
+/** A run of owners, keyed by the hash of its contents and shared by every snapshot that contains it.
+ *  The number of snapshots using it is stored next to it, so taking a reference doesn't rewrite the owners. */
+class CAssetSnapshotDBChunk
+{
+public:
+    std::vector<std::pair<std::string, CAmount>> vOwnersAndAmounts;
+
+    CAssetSnapshotDBChunk()
+    {
+        SetNull();
+    }
+
+    void SetNull()
+    {
+        vOwnersAndAmounts.clear();
+    }
+
+    // Serialization methods
+    ADD_SERIALIZE_METHODS;
+
+    template<typename Stream, typename Operation>
+    inline void SerializationOp(Stream &s, Operation ser_action)
+    {
+        READWRITE(vOwnersAndAmounts);
+    }
+};
+
 class CAssetSnapshotDB  : public CDBWrapper {
 public:
     explicit CAssetSnapshotDB(size_t nCacheSize, bool fMemory = false, bool fWipe = false);
@@ -69,9 +135,30 @@ public:
         const std::string & p_assetName, int p_height,
         CAssetSnapshotDBEntry & p_snapshotEntry);
 
+    //  Call p_func with every owner of the snapshot at the specified height, holding only one chunk of it in
+    //      memory. Stops early and returns false if p_func does. Owners come in assets database order, where
+    //      addresses are ordered by length first, not sorted by address like RetrieveOwnershipSnapshot returns them.
+    bool ForEachOwnerInSnapshot(
+        const std::string & p_assetName, int p_height,
+        const std::function<bool(const std::string &, CAmount)> & p_func);
+
+    //  Returns true if there is a snapshot of the asset at the specified height
+    bool ContainsOwnershipSnapshot(
+        const std::string & p_assetName, int p_height);
+
     //  Remove the asset snapshot at the specified height
     bool RemoveOwnershipSnapshot(
         const std::string & p_assetName, int p_height);
+
+private:
+    //  Erase the snapshot stored under p_heightAndName in p_batch, counting down the references of its chunks
+    void ReleaseSnapshot(const std::string & p_heightAndName, CDBBatch & p_batch, std::map<uint256, int> & p_refChanges);
+
+    //  Returns the hash of a chunk of owners, writing it to p_batch unless it is stored already
+    uint256 AddSnapshotChunk(const std::vector<std::pair<std::string, CAmount>> & p_ownersAndAmounts, CDBBatch & p_batch, std::set<uint256> & p_newChunks);
+
+    //  Apply the reference count changes of chunks in p_batch, erasing the chunks no snapshot uses anymore
+    void WriteChunkRefChanges(const std::map<uint256, int> & p_refChanges, CDBBatch & p_batch);
 };
 
 
@@ -4,6 +4,9 @@
 
 #include "assettypes.h"
 #include "hash.h"
+#include "random.h"
+
+#include <limits>
 
 int IntFromAssetType(AssetType type) {
     return (int)type;
@@ -24,3 +27,5 @@ uint256 CAssetCacheRestrictedAddress::GetHash() {
 uint256 CAssetCacheRootQualifierChecker::GetHash() {
     return Hash(rootAssetName.begin(), rootAssetName.end(), address.begin(), address.end());
 }
+
+CSaltedAssetHasher::CSaltedAssetHasher() : k0(GetRand(std::numeric_limits<uint64_t>::max())), k1(GetRand(std::numeric_limits<uint64_t>::max())) {}
@@ -11,6 +11,8 @@
 #include <list>
 #include <unordered_map>
 #include "amount.h"
+#include "hash.h"
+#include "memusage.h"
 #include "script/standard.h"
 #include "primitives/transaction.h"
 
@@ -408,6 +410,42 @@ struct CAssetCacheNewTransfer
     {
         return out < rhs.out;
     }
+
+    bool operator==(const CAssetCacheNewTransfer& rhs) const
+    {
+        return out == rhs.out;
+    }
+};
+
+/** Random salt shared by the hashers of the asset caches. Not const so the caches stay copy assignable */
+class CSaltedAssetHasher
+{
+protected:
+    uint64_t k0, k1;
+
+    CSaltedAssetHasher();
+};
+
+/** Salted hasher for the transfer caches, keyed by outpoint like CAssetCacheNewTransfer::operator< */
+class CAssetCacheNewTransferHasher : private CSaltedAssetHasher
+{
+public:
+    size_t operator()(const CAssetCacheNewTransfer& transfer) const {
+        return SipHashUint256Extra(k0, k1, transfer.out.hash, transfer.out.n);
+    }
+};
+
+/** Salted hasher for the < Asset Name, Address > pairs keying the address amounts */
+class CAssetAddressHasher : private CSaltedAssetHasher
+{
+public:
+    size_t operator()(const std::pair<std::string, std::string>& key) const {
+        // The length of the name keeps ("AB", "C") and ("A", "BC") apart
+        return CSipHasher(k0, k1).Write(key.first.size())
+                .Write((const unsigned char*)key.first.data(), key.first.size())
+                .Write((const unsigned char*)key.second.data(), key.second.size())
+                .Finalize();
+    }
 };
 
 struct CAssetCacheNewOwner
@@ -548,7 +586,7 @@ struct CAssetCacheRestrictedVerifiers
 };
 
 // Least Recently Used Cache
-template<typename cache_key_t, typename cache_value_t>
+template<typename cache_key_t, typename cache_value_t, typename cache_hasher_t = std::hash<cache_key_t>>
 class CLRUCache
 {
 public:
@@ -641,7 +679,7 @@ public:
         maxSize = size;
     }
 
-   const std::unordered_map<cache_key_t, list_iterator_t>& GetItemsMap()
+   const std::unordered_map<cache_key_t, list_iterator_t, cache_hasher_t>& GetItemsMap()
     {
         return cacheItemsMap;
     };
@@ -661,8 +699,165 @@ public:
 
 private:
     std::list<key_value_pair_t> cacheItemsList;
-    std::unordered_map<cache_key_t, list_iterator_t> cacheItemsMap;
+    std::unordered_map<cache_key_t, list_iterator_t, cache_hasher_t> cacheItemsMap;
     size_t maxSize;
 };
 
+/**
+ * Memory bounded cache of the asset metadata read from the assets database, keyed by asset name.
+ * Entries are evicted with the CLOCK algorithm: a lookup marks its entry referenced, and the clock hand
+ * gives referenced entries a second chance before evicting them. This approximates LRU without the list
+ * node CLRUCache keeps per entry, and without reordering anything on a hit.
+ */
+class CAssetMetaDataCache
+{
+public:
+    explicit CAssetMetaDataCache(size_t nMaxMemoryIn) : nMaxMemory(nMaxMemoryIn), nMemoryUsage(0), nHand(0), nHits(0), nMisses(0) {}
+
+    void Put(const std::string& name, const CDatabasedAssetData& data)
+    {
+        auto it = mapEntries.find(name);
+        if (it != mapEntries.end()) {
+            nMemoryUsage -= EntryUsage(*it);
+            it->second.data = data;
+            it->second.fReferenced = true;
+        } else {
+            // New entries start unreferenced, so they are evicted before entries that were read again
+            it = mapEntries.emplace(name, Entry(data)).first;
+            if (vFreeSlots.empty()) {
+                it->second.nSlot = vClock.size();
+                vClock.push_back(&*it);
+            } else {
+                it->second.nSlot = vFreeSlots.back();
+                vFreeSlots.pop_back();
+                vClock[it->second.nSlot] = &*it;
+            }
+        }
+        nMemoryUsage += EntryUsage(*it);
+
+        while (DynamicMemoryUsage() > nMaxMemory && mapEntries.size() > 1)
+            Evict();
+    }
+
+    void Erase(const std::string& name)
+    {
+        auto it = mapEntries.find(name);
+        if (it != mapEntries.end())
+            EraseEntry(it);
+    }
+
+    //! Copies the metadata of the asset to data if it is cached, counting the hit or miss
+    bool Lookup(const std::string& name, CDatabasedAssetData& data)
+    {
+        auto it = mapEntries.find(name);
+        if (it == mapEntries.end()) {
+            nMisses++;
+            return false;
+        }
+
+        nHits++;
+        it->second.fReferenced = true;
+        data = it->second.data;
+        return true;
+    }
+
+    //! Whether the asset is cached, counting the hit or miss
+    bool Exists(const std::string& name)
+    {
+        auto it = mapEntries.find(name);
+        if (it == mapEntries.end()) {
+            nMisses++;
+            return false;
+        }
+
+        nHits++;
+        it->second.fReferenced = true;
+        return true;
+    }
+
+    size_t Size() const
+    {
+        return mapEntries.size();
+    }
+
+    size_t MaxMemory() const
+    {
+        return nMaxMemory;
+    }
+
+    size_t DynamicMemoryUsage() const
+    {
+        return nMemoryUsage + memusage::DynamicUsage(vClock) + memusage::DynamicUsage(vFreeSlots) + memusage::MallocUsage(mapEntries.bucket_count() * sizeof(void*));
+    }
+
+    uint64_t Hits() const { return nHits; }
+    uint64_t Misses() const { return nMisses; }
+
+    void Clear()
+    {
+        mapEntries.clear();
+        vClock.clear();
+        vFreeSlots.clear();
+        nMemoryUsage = 0;
+        nHand = 0;
+    }
+
+private:
+    struct Entry
+    {
+        CDatabasedAssetData data;
+        size_t nSlot;
+        bool fReferenced;
+
+        explicit Entry(const CDatabasedAssetData& dataIn) : data(dataIn), nSlot(0), fReferenced(false) {}
+    };
+    typedef std::unordered_map<std::string, Entry> EntryMap;
+
+    //! Heap memory of an entry: its map node, its clock slot and the strings it owns
+    static size_t EntryUsage(const EntryMap::value_type& entry)
+    {
+        const CNewAsset& asset = entry.second.data.asset;
+        return memusage::MallocUsage(sizeof(EntryMap::value_type) + 2 * sizeof(void*)) + sizeof(void*) +
+               memusage::DynamicUsage(entry.first) + memusage::DynamicUsage(asset.strName) + memusage::DynamicUsage(asset.strIPFSHash) + memusage::DynamicUsage(asset.strANSID);
+    }
+
+    void EraseEntry(EntryMap::iterator it)
+    {
+        nMemoryUsage -= EntryUsage(*it);
+        vClock[it->second.nSlot] = nullptr;
+        vFreeSlots.push_back(it->second.nSlot);
+        mapEntries.erase(it);
+    }
+
+    //! Advances the clock hand to the first entry not referenced since the hand last passed, and evicts it
+    void Evict()
+    {
+        while (true) {
+            if (nHand >= vClock.size())
+                nHand = 0;
+
+            EntryMap::value_type* pEntry = vClock[nHand++];
+            if (!pEntry)
+                continue;
+
+            if (pEntry->second.fReferenced) {
+                pEntry->second.fReferenced = false;
+                continue;
+            }
+
+            EraseEntry(mapEntries.find(pEntry->first));
+            return;
+        }
+    }
+
+    EntryMap mapEntries;
+    std::vector<EntryMap::value_type*> vClock; //! The entries by slot, nullptr for a free slot
+    std::vector<size_t> vFreeSlots;
+    size_t nMaxMemory;
+    size_t nMemoryUsage;
+    size_t nHand;
+    uint64_t nHits;
+    uint64_t nMisses;
+};
+
 #endif //AVIAN_NEWASSET_H
@@ -172,6 +172,11 @@ bool CRestrictedDB::GetAddressQualifiers(std::string& address, std::vector<std::
 {
     FlushStateToDisk();
 
+    return ReadAddressQualifiers(address, qualifiers);
+}
+
+bool CRestrictedDB::ReadAddressQualifiers(const std::string& address, std::vector<std::string>& qualifiers)
+{
     std::unique_ptr<CDBIterator> pcursor(NewIterator());
 
     pcursor->Seek(std::make_pair(ADDRESS_QULAIFIER_FLAG, std::make_pair(address, std::string())));
@@ -52,6 +52,9 @@ public:
 
     bool CheckForAddressRootQualifier(const std::string& address, const std::string& qualifier);
 
+    // Qualifiers assigned to the address in the database, without flushing the caches first
+    bool ReadAddressQualifiers(const std::string& address, std::vector<std::string>& qualifiers);
+
     bool Flush();
 };
 
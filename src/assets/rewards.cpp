@@ -17,8 +17,11 @@
 #include <utilmoneystr.h>
 #include "assets/rewards.h"
 #include "assetsnapshotdb.h"
+#include "taskqueue.h"
 #include "wallet/wallet.h"
 
+#include <algorithm>
+
 std::map<uint256, CRewardSnapshot> mapRewardSnapshots;
 
 uint256 CRewardSnapshot::GetHash() const
@@ -111,29 +114,30 @@ bool GenerateDistributionList(const CRewardSnapshot& p_rewardSnapshot, std::vect
     std::set<std::string> exceptionAddressSet;
     boost::split(exceptionAddressSet, p_rewardSnapshot.strExceptionAddresses, boost::is_any_of(ADDRESS_COMMA_DELIMITER));
 
-    std::set<OwnerAndAmount> nonExceptionOwnerships;
+    //  Ignore exception and burn addresses
+    auto isPayableOwner = [&exceptionAddressSet](const std::string & p_address) {
+        return exceptionAddressSet.find(p_address) == exceptionAddressSet.end()
+                && !Params().IsBurnAddress(p_address);
+    };
+
+    //  The snapshot is streamed twice instead of being held in memory: once for the total, once for the rewards
+    size_t nonExceptionOwnerCount = 0;
     CAmount totalAmtOwned = 0;
 
-    CAssetSnapshotDBEntry snapshotEntry;
-    if (!pAssetSnapshotDb->RetrieveOwnershipSnapshot(p_rewardSnapshot.strOwnershipAsset, p_rewardSnapshot.nHeight, snapshotEntry)) {
+    if (!pAssetSnapshotDb->ForEachOwnerInSnapshot(p_rewardSnapshot.strOwnershipAsset, p_rewardSnapshot.nHeight,
+            [&](const std::string & p_address, CAmount p_amount) {
+                if (isPayableOwner(p_address)) {
+                    nonExceptionOwnerCount += 1;
+                    totalAmtOwned += p_amount;
+                }
+                return true;
+            })) {
         LogPrint(BCLog::REWARDS, "%s: Failed to retrieve ownership snapshot list!\n", __func__);
         return false;
     }
 
-    for (auto const & currPair : snapshotEntry.ownersAndAmounts) {
-        //  Ignore exception and burn addresses
-        if (
-                exceptionAddressSet.find(currPair.first) == exceptionAddressSet.end()
-                && !Params().IsBurnAddress(currPair.first)
-                ) {
-            //  Address is valid so add it to the payment list
-            nonExceptionOwnerships.insert(OwnerAndAmount(currPair.first, currPair.second));
-            totalAmtOwned += currPair.second;
-        }
-    }
-
     //  Make sure we have some addresses to pay to
-    if (nonExceptionOwnerships.size() == 0) {
+    if (nonExceptionOwnerCount == 0) {
         LogPrint(BCLog::REWARDS, "%s: Ownership of '%s' includes only exception/burn addresses.\n", __func__,
                  p_rewardSnapshot.strOwnershipAsset.c_str());
         return false;
@@ -147,27 +151,39 @@ bool GenerateDistributionList(const CRewardSnapshot& p_rewardSnapshot, std::vect
 
     CAmount totalSentAsRewards = 0;
     //  Loop through asset owners
-    for (auto & ownership : nonExceptionOwnerships) {
-        // Get percentage of total ownership
-        long double percent = (long double)ownership.amount / (long double)totalAmtOwned;
-        // Caculate the reward with potentional unit inaccurancies e.g with units 4, 90054100 satoshis = 0.90054100
-        CAmount rewardAmt = percent * modifiedPaymentInAssetUnits * static_cast<CAmount>(pow(10, COIN_DIGITS_PAST_DECIMAL - distributionAsset.units));
-        // Remove all none accurate units e.g with units 4 90054100 => 9005
-        rewardAmt /= static_cast<CAmount>(pow(10, COIN_DIGITS_PAST_DECIMAL - distributionAsset.units));
-        // Replace all none accurate units back with zeros e.g with units 4 9005 => 90050000 satoshis = 0.90050000
-        rewardAmt *= static_cast<CAmount>(pow(10, COIN_DIGITS_PAST_DECIMAL - distributionAsset.units));
-
-        totalSentAsRewards += rewardAmt;
-
-        LogPrint(BCLog::REWARDS, "%s: Found ownership address for '%s': '%s' owns %d => reward %d\n", __func__,
-                 p_rewardSnapshot.strOwnershipAsset.c_str(), ownership.address.c_str(),
-                 ownership.amount, rewardAmt);
-
-        //  Save it into our list if the reward payment is above zero
-        if (rewardAmt > 0)
-            vecDistributionList.push_back(OwnerAndAmount(ownership.address, rewardAmt));
+    if (!pAssetSnapshotDb->ForEachOwnerInSnapshot(p_rewardSnapshot.strOwnershipAsset, p_rewardSnapshot.nHeight,
+            [&](const std::string & p_address, CAmount p_amount) {
+                if (!isPayableOwner(p_address))
+                    return true;
+
+                // Get percentage of total ownership
+                long double percent = (long double)p_amount / (long double)totalAmtOwned;
+                // Caculate the reward with potentional unit inaccurancies e.g with units 4, 90054100 satoshis = 0.90054100
+                CAmount rewardAmt = percent * modifiedPaymentInAssetUnits * static_cast<CAmount>(pow(10, COIN_DIGITS_PAST_DECIMAL - distributionAsset.units));
+                // Remove all none accurate units e.g with units 4 90054100 => 9005
+                rewardAmt /= static_cast<CAmount>(pow(10, COIN_DIGITS_PAST_DECIMAL - distributionAsset.units));
+                // Replace all none accurate units back with zeros e.g with units 4 9005 => 90050000 satoshis = 0.90050000
+                rewardAmt *= static_cast<CAmount>(pow(10, COIN_DIGITS_PAST_DECIMAL - distributionAsset.units));
+
+                totalSentAsRewards += rewardAmt;
+
+                LogPrint(BCLog::REWARDS, "%s: Found ownership address for '%s': '%s' owns %d => reward %d\n", __func__,
+                         p_rewardSnapshot.strOwnershipAsset.c_str(), p_address.c_str(),
+                         p_amount, rewardAmt);
+
+                //  Save it into our list if the reward payment is above zero
+                if (rewardAmt > 0)
+                    vecDistributionList.push_back(OwnerAndAmount(p_address, rewardAmt));
+                return true;
+            })) {
+        LogPrint(BCLog::REWARDS, "%s: Failed to retrieve ownership snapshot list!\n", __func__);
+        return false;
     }
 
+    //  Owners are streamed in assets database order, sort them by address like the holder set they used to
+    //      come from, so that distributions are still split into the same batches
+    std::sort(vecDistributionList.begin(), vecDistributionList.end());
+
     CAmount change = totalAmtOwned - totalSentAsRewards;
     if (change > 0) {
         LogPrint(BCLog::REWARDS, "%s: Found change amount of %u\n", __func__, change);
@@ -178,49 +194,191 @@ bool GenerateDistributionList(const CRewardSnapshot& p_rewardSnapshot, std::vect
 
 #ifdef ENABLE_WALLET
 
-void DistributeRewardSnapshot(CWallet * p_wallet, const CRewardSnapshot& p_rewardSnapshot)
+//  A batch of up to MAX_PAYMENTS_PER_TRANSACTION payments, funded but not yet signed or committed
+struct CRewardBatch
 {
-    if (p_wallet->IsLocked()) {
-        LogPrint(BCLog::REWARDS, "Skipping distribution: Wallet is locked!\n");
-        return;
+    int nBatchNumber;
+    CWalletTx wtx;
+    std::unique_ptr<CReserveKey> reserveKey;
+    std::vector<CTxOut> vSpentOutputs;
+    bool fSigned;
+
+    CRewardBatch(CWallet * const p_walletPtr, int p_batchNumber);
+};
+
+//  Update the status of a distribution in memory and in the database
+static void SetRewardSnapshotStatus(const uint256& p_rewardSnapshotHash, int p_status)
+{
+    mapRewardSnapshots[p_rewardSnapshotHash].nStatus = p_status;
+    pDistributeSnapshotDb->OverrideDistributeSnapshot(p_rewardSnapshotHash, mapRewardSnapshots[p_rewardSnapshotHash]);
+}
+
+CRewardBatch::CRewardBatch(CWallet * const p_walletPtr, int p_batchNumber)
+{
+    nBatchNumber = p_batchNumber;
+    reserveKey.reset(new CReserveKey(p_walletPtr));
+    fSigned = false;
+}
+
+//  Select the coins and build the unsigned transaction of a batch, p_failStatus is set when it can't be funded
+static bool FundRewardBatch(
+        CWallet * const p_walletPtr, const CRewardSnapshot& p_rewardSnapshot,
+        const std::vector<OwnerAndAmount> & p_pendingPayments, const std::string& change_address,
+        CRewardBatch& p_batch, int& p_failStatus, std::string& p_error)
+{
+    int start = p_batch.nBatchNumber * MAX_PAYMENTS_PER_TRANSACTION;
+    int stop = start + MAX_PAYMENTS_PER_TRANSACTION;
+
+    //  Transfer the specified amount of the asset from the source to the target
+    CCoinControl ctrl;
+    ctrl.destChange = DecodeDestination(change_address);
+    ctrl.assetDestChange = DecodeDestination(change_address);
+    CAmount nFeeRequired = 0;
+
+    //  Handle payouts using AVN differently from those using an asset
+    if (p_rewardSnapshot.strDistributionAsset == "AVN") {
+        std::vector<CRecipient> vDestinations;
+        CAmount totalPaymentAmt = 0;
+
+        for (int i = start; i < (int)p_pendingPayments.size() && i < stop; i++) {
+            // Parse Avian address (already validated during ownership snapshot creation)
+            CTxDestination dest = DecodeDestination(p_pendingPayments[i].address);
+            CScript scriptPubKey = GetScriptForDestination(dest);
+            CRecipient recipient = {scriptPubKey, p_pendingPayments[i].amount, false};
+            vDestinations.emplace_back(recipient);
+
+            totalPaymentAmt += p_pendingPayments[i].amount;
+        }
+
+        //  Signed later, together with the other batches
+        int nChangePosRet = -1;
+        if (!p_walletPtr->CreateTransaction(vDestinations, p_batch.wtx, *p_batch.reserveKey, nFeeRequired, nChangePosRet, p_error, ctrl, false)) {
+            if (totalPaymentAmt + nFeeRequired > p_walletPtr->GetBalance()) {
+                p_failStatus = CRewardSnapshot::NOT_ENOUGH_FEE;
+                p_error = strprintf("Error: This transaction requires a transaction fee of at least %s",
+                                    FormatMoney(nFeeRequired));
+            } else {
+                p_failStatus = CRewardSnapshot::FAILED_CREATE_TRANSACTION;
+            }
+            return false;
+        }
     }
+    else {
+        std::pair<int, std::string> error;
+        std::vector< std::pair<CAssetTransfer, std::string> > vDestinations;
 
-    if (IsInitialBlockDownload()) {
-        LogPrint(BCLog::REWARDS, "Skipping distribution: Syncing Chain!\n");
-        return;
+        for (int i = start; i < (int)p_pendingPayments.size() && i < stop; i++) {
+            vDestinations.emplace_back(std::make_pair(
+                    CAssetTransfer(p_rewardSnapshot.strDistributionAsset, p_pendingPayments[i].amount, DecodeAssetData(""), 0), p_pendingPayments[i].address));
+        }
+
+        // Create the Transaction (this also verifies dest address), signed later together with the other batches
+        if (!CreateTransferAssetTransaction(p_walletPtr, ctrl, vDestinations, "", error, p_batch.wtx, *p_batch.reserveKey, nFeeRequired, nullptr, nullptr, false)) {
+            p_failStatus = CRewardSnapshot::FAILED_CREATE_TRANSACTION;
+            p_error = error.second;
+            return false;
+        }
     }
 
-    //  Retrieve the asset snapshot entry for the target asset at the specified height
-    CAssetSnapshotDBEntry snapshotEntry;
+    return true;
+}
 
-    if (!pAssetSnapshotDb->RetrieveOwnershipSnapshot(p_rewardSnapshot.strOwnershipAsset, p_rewardSnapshot.nHeight, snapshotEntry)) {
-        LogPrint(BCLog::REWARDS, "Failed to retrieve ownership snapshot!\n");
-        return;
+//  Look up the outputs a funded batch spends, so it can be signed without the wallet lock
+static void GetRewardBatchSpentOutputs(CWallet * const p_walletPtr, CRewardBatch& p_batch)
+{
+    AssertLockHeld(p_walletPtr->cs_wallet); // mapWallet
+
+    for (const auto& input : p_batch.wtx.tx->vin) {
+        auto mi = p_walletPtr->mapWallet.find(input.prevout.hash);
+        if (mi == p_walletPtr->mapWallet.end() || input.prevout.n >= mi->second.tx->vout.size())
+            return;
+        p_batch.vSpentOutputs.push_back(mi->second.tx->vout[input.prevout.n]);
+    }
+}
+
+//  Sign the funded batches on the shared task queue with the wallet's keys only, fSigned tells which ones succeeded
+static void SignRewardBatches(const CKeyStore& p_keyStore, std::vector<std::unique_ptr<CRewardBatch>>& p_batches, uint32_t p_hashType)
+{
+    std::vector<CTaskCheck> vTasks;
+    for (auto& batch : p_batches) {
+        CRewardBatch* pBatch = batch.get();
+        vTasks.emplace_back([&p_keyStore, pBatch, p_hashType]() {
+            CMutableTransaction tx(*pBatch->wtx.tx);
+            if (pBatch->vSpentOutputs.size() != tx.vin.size())
+                return false;
+
+            CTransaction txNewConst(tx);
+            for (unsigned int nIn = 0; nIn < tx.vin.size(); nIn++) {
+                const CTxOut& spent = pBatch->vSpentOutputs[nIn];
+                SignatureData sigdata;
+                if (!ProduceSignature(TransactionSignatureCreator(&p_keyStore, &txNewConst, nIn, spent.nValue, p_hashType), spent.scriptPubKey, sigdata))
+                    return false;
+                UpdateTransaction(tx, nIn, sigdata);
+            }
+
+            pBatch->wtx.SetTx(MakeTransactionRef(std::move(tx)));
+            pBatch->fSigned = true;
+            return true;
+        });
     }
+    RunTasks(vTasks);
+}
 
-    //  Generate payment transactions and store in the payments DB
-    std::vector<OwnerAndAmount> paymentDetails;
-    if (!GenerateDistributionList(p_rewardSnapshot, paymentDetails)) {
-        LogPrint(BCLog::REWARDS, "Failed to generate payment details!\n");
-        return;
+//  Fund as many of the pending batches as the wallet's coins allow, from nNextPending on. Each batch locks its
+//      inputs so the next one picks others, the rest are funded from the change of these once they are committed.
+static bool FundRewardBatches(
+        CWallet * const p_walletPtr, const CRewardSnapshot& p_rewardSnapshot,
+        const std::vector<OwnerAndAmount> & p_pendingPayments, const std::string& change_address,
+        const std::vector<int>& p_pendingBatches, size_t& p_nextPending, std::vector<std::unique_ptr<CRewardBatch>>& p_fundedBatches)
+{
+    AssertLockHeld(p_walletPtr->cs_wallet);
+
+    int nFailStatus = CRewardSnapshot::REWARD_ERROR;
+    std::string strError;
+    while (p_nextPending < p_pendingBatches.size()) {
+        std::unique_ptr<CRewardBatch> batch(new CRewardBatch(p_walletPtr, p_pendingBatches[p_nextPending]));
+        if (!FundRewardBatch(p_walletPtr, p_rewardSnapshot, p_pendingPayments, change_address, *batch, nFailStatus, strError))
+            break;
+
+        GetRewardBatchSpentOutputs(p_walletPtr, *batch);
+        for (const auto& input : batch->wtx.tx->vin)
+            p_walletPtr->LockCoin(input.prevout);
+        p_fundedBatches.push_back(std::move(batch));
+        p_nextPending++;
+    }
+
+    if (p_fundedBatches.empty()) {
+        SetRewardSnapshotStatus(p_rewardSnapshot.GetHash(), nFailStatus);
+        LogPrint(BCLog::REWARDS, "Failed to build Tx: distribute: %s, amount: %d: %s\n", p_rewardSnapshot.strDistributionAsset, p_rewardSnapshot.nDistributionAmount, strError);
+        return false;
     }
 
+    return true;
+}
+
+//  Find the batches of a distribution that still need a transaction and check the funds for all of them,
+//      returns false when there is nothing to do now
+static bool GetPendingRewardBatches(CWallet * p_wallet, const CRewardSnapshot& p_rewardSnapshot, const std::vector<OwnerAndAmount>& paymentDetails, std::vector<int>& vPendingBatches)
+{
+    AssertLockHeld(cs_main);
+    AssertLockHeld(p_wallet->cs_wallet);
+
+    auto rewardSnapshotHash = p_rewardSnapshot.GetHash();
+
+    //  Find the batches that still need a transaction, waiting for one that hasn't confirmed yet
     int nNumberOfTransactions = ((int)paymentDetails.size() / MAX_PAYMENTS_PER_TRANSACTION) + 1;
-    CRewardSnapshot copyRewardSnapshot = p_rewardSnapshot;
     for (int i = 0; i < nNumberOfTransactions; i++) {
         uint256 txid;
-        if (pDistributeSnapshotDb->GetDistributeTransaction(p_rewardSnapshot.GetHash(), i, txid)) {
-            CTransactionRef txRef;
-            uint256 hashBlock;
+        if (pDistributeSnapshotDb->GetDistributeTransaction(rewardSnapshotHash, i, txid)) {
             auto walletTx = p_wallet->GetWalletTx(txid);
             if (walletTx) {
                 int depth = walletTx->GetDepthInMainChain();
                 if (depth < 0) {
                     LogPrint(BCLog::REWARDS, "Failed distribution: Tx conflict with another tx: %s: number of block back %d!\n", txid.GetHex(), depth);
-                    return;
+                    return false;
                 } else if (depth == 0) {
                     LogPrint(BCLog::REWARDS, "Tx is in the mempool! %s\n", txid.GetHex());
-                    return;
+                    return false;
                 } else if (depth > 0) {
                     LogPrint(BCLog::REWARDS, "Tx is in a block %s!\n", txid.GetHex());
                     continue;
@@ -230,156 +388,130 @@ void DistributeRewardSnapshot(CWallet * p_wallet, const CRewardSnapshot& p_rewar
             }
         } else {
             LogPrint(BCLog::REWARDS, "Didn't find transaction in database creating new transaction: %s %s %d %d\n", p_rewardSnapshot.strOwnershipAsset, p_rewardSnapshot.strDistributionAsset, p_rewardSnapshot.nDistributionAmount, i);
-            // Create a new transaction and database it
-            int start = i * MAX_PAYMENTS_PER_TRANSACTION;
-            uint256 retTxid;
-            std::string change = "";
-            if (!BuildTransaction(p_wallet, p_rewardSnapshot, paymentDetails, start, change, retTxid)) {
-                LogPrint(BCLog::REWARDS, "Failed to build Tx: distribute: %s, amount: %d\n", p_rewardSnapshot.strDistributionAsset, p_rewardSnapshot.nDistributionAmount);
-                return;
-            }
-            pDistributeSnapshotDb->AddDistributeTransaction(p_rewardSnapshot.GetHash(), i, retTxid);
+            vPendingBatches.push_back(i);
         }
     }
-}
-
-bool BuildTransaction(
-        CWallet * const p_walletPtr, const CRewardSnapshot& p_rewardSnapshot,
-        const std::vector<OwnerAndAmount> & p_pendingPayments,const int& start,
-        std::string& change_address, uint256& retTxid)
-{
-    int expectedCount = 0;
-    int actualCount = 0;
-    CValidationState state;
 
-    int stop = start + MAX_PAYMENTS_PER_TRANSACTION;
-    CRewardSnapshot copyRewardSnapshot = p_rewardSnapshot;
-    auto rewardSnapshotHash = p_rewardSnapshot.GetHash();
-
-    LogPrint(BCLog::REWARDS, "Generating transactions for payments...\n");
+    if (vPendingBatches.empty())
+        return false;
 
-    //  Transfer the specified amount of the asset from the source to the target
-    CCoinControl ctrl;
-    ctrl.destChange = DecodeDestination(change_address);
-    ctrl.assetDestChange = DecodeDestination(change_address);
-    std::shared_ptr<CWalletTx> txnPtr = std::make_shared<CWalletTx>();
-    std::shared_ptr<CReserveKey> reserveKeyPtr = std::make_shared<CReserveKey>(p_walletPtr);
-    std::shared_ptr<UniValue> batchResult = std::make_shared<UniValue>(UniValue::VOBJ);
-    CAmount nFeeRequired = 0;
+    //  Check the funds once for every pending batch instead of once per batch
     CAmount totalPaymentAmt = 0;
+    for (int nBatchNumber : vPendingBatches) {
+        int start = nBatchNumber * MAX_PAYMENTS_PER_TRANSACTION;
+        for (int i = start; i < (int)paymentDetails.size() && i < start + MAX_PAYMENTS_PER_TRANSACTION; i++)
+            totalPaymentAmt += paymentDetails[i].amount;
+    }
 
-
-    //  Handle payouts using AVN differently from those using an asset
     if (p_rewardSnapshot.strDistributionAsset == "AVN") {
-        // Check amount
-        CAmount curBalance = p_walletPtr->GetBalance();
-
-        if (p_walletPtr->GetBroadcastTransactions() && !g_connman) {
-            mapRewardSnapshots[rewardSnapshotHash].nStatus = CRewardSnapshot::NETWORK_ERROR;
-            pDistributeSnapshotDb->OverrideDistributeSnapshot(rewardSnapshotHash, mapRewardSnapshots.at(rewardSnapshotHash));
+        if (p_wallet->GetBroadcastTransactions() && !g_connman) {
+            SetRewardSnapshotStatus(rewardSnapshotHash, CRewardSnapshot::NETWORK_ERROR);
             LogPrint(BCLog::REWARDS, "Error: Peer-to-peer functionality missing or disabled\n");
             return false;
         }
 
-        std::vector<CRecipient> vDestinations;
-
-        //  This should (due to external logic) only include pending payments
-        for (int i = start; i < (int)p_pendingPayments.size() && i < stop; i++) {
-            expectedCount++;
-
-            // Parse Avian address (already validated during ownership snapshot creation)
-            CTxDestination dest = DecodeDestination(p_pendingPayments[i].address);
-            CScript scriptPubKey = GetScriptForDestination(dest);
-            CRecipient recipient = {scriptPubKey, p_pendingPayments[i].amount, false};
-            vDestinations.emplace_back(recipient);
-
-            totalPaymentAmt += p_pendingPayments[i].amount;
-            actualCount++;
-        }
-
-        //  Verify funds
+        CAmount curBalance = p_wallet->GetBalance();
         if (totalPaymentAmt > curBalance) {
-            mapRewardSnapshots[rewardSnapshotHash].nStatus = CRewardSnapshot::LOW_FUNDS;
-            pDistributeSnapshotDb->OverrideDistributeSnapshot(rewardSnapshotHash, mapRewardSnapshots[rewardSnapshotHash]);
+            SetRewardSnapshotStatus(rewardSnapshotHash, CRewardSnapshot::LOW_FUNDS);
             LogPrint(BCLog::REWARDS, "Insufficient funds: total payment %lld > available balance %lld\n",
                      totalPaymentAmt, curBalance);
             return false;
         }
-
-        // Create and send the transaction
-        std::string strError;
-        int nChangePosRet = -1;
-
-        if (!p_walletPtr->CreateTransaction(vDestinations, *txnPtr.get(), *reserveKeyPtr.get(), nFeeRequired, nChangePosRet, strError, ctrl)) {
-            if (totalPaymentAmt + nFeeRequired > curBalance) {
-                mapRewardSnapshots[rewardSnapshotHash].nStatus = CRewardSnapshot::NOT_ENOUGH_FEE;
-                pDistributeSnapshotDb->OverrideDistributeSnapshot(rewardSnapshotHash, mapRewardSnapshots.at(rewardSnapshotHash));
-                strError = strprintf("Error: This transaction requires a transaction fee of at least %s",
-                                     FormatMoney(nFeeRequired));
-            } else {
-                mapRewardSnapshots[rewardSnapshotHash].nStatus = CRewardSnapshot::FAILED_CREATE_TRANSACTION;
-                pDistributeSnapshotDb->OverrideDistributeSnapshot(rewardSnapshotHash, mapRewardSnapshots.at(rewardSnapshotHash));
-            }
-
-            LogPrint(BCLog::REWARDS, "%s\n", strError.c_str());
+    } else {
+        CAmount totalAssetBalance = 0;
+        GetMyAssetBalance(p_rewardSnapshot.strDistributionAsset, totalAssetBalance, 0);
+        if (totalPaymentAmt > totalAssetBalance) {
+            SetRewardSnapshotStatus(rewardSnapshotHash, CRewardSnapshot::LOW_REWARDS);
+            LogPrint(BCLog::REWARDS, "Insufficient asset funds: total payment %lld > available balance %lld\n",
+                     totalPaymentAmt, totalAssetBalance);
             return false;
         }
+    }
 
-        if (!p_walletPtr->CommitTransaction(*txnPtr.get(), *reserveKeyPtr.get(), g_connman.get(), state)) {
-            mapRewardSnapshots[rewardSnapshotHash].nStatus = CRewardSnapshot::FAILED_COMMIT_TRANSACTION;
-            pDistributeSnapshotDb->OverrideDistributeSnapshot(rewardSnapshotHash, mapRewardSnapshots.at(rewardSnapshotHash));
-            LogPrint(BCLog::REWARDS, "%s\n", state.GetRejectReason());
-            return false;
-        }
+    return true;
+}
+
+void DistributeRewardSnapshot(CWallet * p_wallet, const CRewardSnapshot& p_rewardSnapshot)
+{
+    if (p_wallet->IsLocked()) {
+        LogPrint(BCLog::REWARDS, "Skipping distribution: Wallet is locked!\n");
+        return;
     }
-    else {
-        std::pair<int, std::string> error;
-        std::vector< std::pair<CAssetTransfer, std::string> > vDestinations;
-        CAmount nTotalAssetAmount = 0;
 
-        // Get the total amount of distribution assets this wallet has
-        CAmount totalAssetBalance = 0;
-        GetMyAssetBalance(p_rewardSnapshot.strDistributionAsset, totalAssetBalance, 0);
+    if (IsInitialBlockDownload()) {
+        LogPrint(BCLog::REWARDS, "Skipping distribution: Syncing Chain!\n");
+        return;
+    }
 
-        //  This should (due to external logic) only include pending payments
-        for (int i = start; i < (int)p_pendingPayments.size() && i < stop; i++) {
-            expectedCount++;
+    //  Make sure there is an asset snapshot for the target asset at the specified height
+    if (!pAssetSnapshotDb->ContainsOwnershipSnapshot(p_rewardSnapshot.strOwnershipAsset, p_rewardSnapshot.nHeight)) {
+        LogPrint(BCLog::REWARDS, "Failed to retrieve ownership snapshot!\n");
+        return;
+    }
 
-            vDestinations.emplace_back(std::make_pair(
-                    CAssetTransfer(p_rewardSnapshot.strDistributionAsset, p_pendingPayments[i].amount, DecodeAssetData(""), 0), p_pendingPayments[i].address));
+    //  Generate payment transactions and store in the payments DB
+    std::vector<OwnerAndAmount> paymentDetails;
+    if (!GenerateDistributionList(p_rewardSnapshot, paymentDetails)) {
+        LogPrint(BCLog::REWARDS, "Failed to generate payment details!\n");
+        return;
+    }
 
-            nTotalAssetAmount += p_pendingPayments[i].amount;
-            actualCount++;
-        }
+    std::vector<int> vPendingBatches;
+    {
+        LOCK2(cs_main, p_wallet->cs_wallet);
+        if (!GetPendingRewardBatches(p_wallet, p_rewardSnapshot, paymentDetails, vPendingBatches))
+            return;
+    }
 
-        if (nTotalAssetAmount > totalAssetBalance) {
-            mapRewardSnapshots[rewardSnapshotHash].nStatus = CRewardSnapshot::LOW_REWARDS;
-            pDistributeSnapshotDb->OverrideDistributeSnapshot(rewardSnapshotHash, mapRewardSnapshots[rewardSnapshotHash]);
-            LogPrint(BCLog::REWARDS, "Insufficient asset funds: total payment %lld > available balance %lld\n",
-                     nTotalAssetAmount, totalAssetBalance);
-            return false;
+    auto rewardSnapshotHash = p_rewardSnapshot.GetHash();
+    int nNumberOfTransactions = ((int)paymentDetails.size() / MAX_PAYMENTS_PER_TRANSACTION) + 1;
+    std::string change = "";
+    size_t nNextPending = 0;
+    while (nNextPending < vPendingBatches.size()) {
+        std::vector<std::unique_ptr<CRewardBatch>> vFundedBatches;
+        uint32_t nHashType = SIGHASH_ALL;
+        {
+            LOCK2(cs_main, p_wallet->cs_wallet);
+            if (IsForkIDUAHFenabledForCurrentBlock()) {
+                nHashType |= SIGHASH_FORKID;
+            }
+            if (!FundRewardBatches(p_wallet, p_rewardSnapshot, paymentDetails, change, vPendingBatches, nNextPending, vFundedBatches))
+                return;
         }
 
-        // Create the Transaction (this also verifies dest address)
-        if (!CreateTransferAssetTransaction(p_walletPtr, ctrl, vDestinations, "", error, *txnPtr.get(), *reserveKeyPtr.get(), nFeeRequired)) {
-            mapRewardSnapshots[rewardSnapshotHash].nStatus = CRewardSnapshot::FAILED_CREATE_TRANSACTION;
-            pDistributeSnapshotDb->OverrideDistributeSnapshot(rewardSnapshotHash, mapRewardSnapshots.at(rewardSnapshotHash));
-            LogPrint(BCLog::REWARDS, "Failed to create transfer asset transaction: %s\n", error.second.c_str());
-            return false;
-        }
+        //  Sign without holding the wallet, the inputs stay locked so nothing else spends them meanwhile
+        SignRewardBatches(*p_wallet, vFundedBatches, nHashType);
+
+        LOCK2(cs_main, p_wallet->cs_wallet);
+        auto unlockFundedBatches = [&]() {
+            for (const auto& batch : vFundedBatches)
+                for (const auto& input : batch->wtx.tx->vin)
+                    p_wallet->UnlockCoin(input.prevout);
+        };
+
+        //  Commit in batch order, recording each one as it goes out
+        for (auto& batch : vFundedBatches) {
+            if (!batch->fSigned) {
+                unlockFundedBatches();
+                SetRewardSnapshotStatus(rewardSnapshotHash, CRewardSnapshot::FAILED_CREATE_TRANSACTION);
+                LogPrint(BCLog::REWARDS, "Failed to sign Tx: distribute: %s, batch %d\n", p_rewardSnapshot.strDistributionAsset, batch->nBatchNumber);
+                return;
+            }
 
-        if (!p_walletPtr->CommitTransaction(*txnPtr.get(), *reserveKeyPtr.get(), g_connman.get(), state)) {
-            mapRewardSnapshots[rewardSnapshotHash].nStatus = CRewardSnapshot::FAILED_COMMIT_TRANSACTION;
-            pDistributeSnapshotDb->OverrideDistributeSnapshot(rewardSnapshotHash, mapRewardSnapshots.at(rewardSnapshotHash));
-            LogPrint(BCLog::REWARDS, "%s\n", state.GetRejectReason());
-            return false;
-        }
-    }
+            CValidationState state;
+            if (!p_wallet->CommitTransaction(batch->wtx, *batch->reserveKey, g_connman.get(), state)) {
+                unlockFundedBatches();
+                SetRewardSnapshotStatus(rewardSnapshotHash, CRewardSnapshot::FAILED_COMMIT_TRANSACTION);
+                LogPrint(BCLog::REWARDS, "%s\n", state.GetRejectReason());
+                return;
+            }
 
-    retTxid = txnPtr->GetHash();
-    LogPrint(BCLog::REWARDS, "Transaction generation succeeded : %s\n", retTxid.GetHex());
+            pDistributeSnapshotDb->AddDistributeTransaction(rewardSnapshotHash, batch->nBatchNumber, batch->wtx.GetHash());
+            LogPrint(BCLog::REWARDS, "Transaction generation succeeded : %s (batch %d of %d)\n", batch->wtx.GetHash().GetHex(), batch->nBatchNumber + 1, nNumberOfTransactions);
+        }
 
-    return true;
+        unlockFundedBatches();
+    }
 }
 
 void CheckRewardDistributions(CWallet * p_wallet)
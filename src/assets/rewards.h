@@ -152,11 +152,6 @@ bool AddDistributeRewardSnapshot(CRewardSnapshot& p_rewardSnapshot);
 #ifdef ENABLE_WALLET
 void DistributeRewardSnapshot(CWallet * p_wallet, const CRewardSnapshot& p_rewardSnapshot);
 
-bool BuildTransaction(
-        CWallet * const p_walletPtr, const CRewardSnapshot& p_rewardSnapshot,
-        const std::vector<OwnerAndAmount> & p_pendingPayments, const int& start,
-        std::string& change_address, uint256& retTxid);
-
 void CheckRewardDistributions(CWallet * p_wallet);
 #endif //ENABLE_WALLET
 
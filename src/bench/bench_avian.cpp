@@ -5,6 +5,7 @@
 
 #include <chainparamsbase.h>
 #include <chainparams.h>
+#include "algo/x16r/x16r_multi.h"
 #include "bench.h"
 #include "crypto/sha256.h"
 #include "key.h"
@@ -16,6 +17,7 @@ int
 main(int argc, char **argv)
 {
     SHA256AutoDetect();
+    X16RMultiAutoDetect();
     RandomInit();
     ECC_Start();
     SetupEnvironment();
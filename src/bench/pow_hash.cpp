@@ -0,0 +1,123 @@
+// Copyright (c) 2022 The Avian Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+#include "algo/minotaurx/minotaurx.h"
+#include "primitives/block.h"
+#include "primitives/powcache.h"
+
+#include <atomic>
+#include <boost/thread/thread.hpp>
+
+// Headers hashed by each thread per iteration. Divide by the reported time per
+// iteration (and multiply by the thread count) to get headers/sec.
+static const int HEADERS_PER_THREAD = 32;
+
+static CBlockHeader MakeBenchHeader(POW_TYPE powType)
+{
+    CBlockHeader header;
+    header.nVersion = 0x20000000 | (powType << 16);
+    header.hashPrevBlock = uint256S("0x000000000000a9a3ae2a3e6e2b1f6b9d2fbc2a1e7b5a3d6e7f8091a2b3c4d5e6");
+    header.hashMerkleRoot = uint256S("0x4a5e1e4baab89f3a32518a88c31bc87f618f76673e2cc77ab2127b7afdeda33b");
+    header.nTime = 1650000000; // After the dual algo activation on mainnet
+    header.nBits = 0x1e00ffff;
+    header.nNonce = 0;
+    return header;
+}
+
+// Every header gets a fresh nonce so each GetHash() is a cache miss, as during
+// header sync: the PoW hash is computed and the result inserted into the cache.
+static void PowHashThreads(benchmark::State& state, int nThreads)
+{
+    static std::atomic<uint32_t> nNonce{0};
+    const CBlockHeader base = MakeBenchHeader(POW_TYPE_X16RT);
+
+    while (state.KeepRunning()) {
+        boost::thread_group tg;
+        for (int t = 0; t < nThreads; t++) {
+            tg.create_thread([&base] {
+                CBlockHeader header(base);
+                for (int i = 0; i < HEADERS_PER_THREAD; i++) {
+                    header.nNonce = nNonce++;
+                    header.GetHash();
+                }
+            });
+        }
+        tg.join_all();
+    }
+}
+
+// All threads repeatedly look up headers that are already cached, which makes
+// contention on the cache itself visible.
+static void PowHashCachedThreads(benchmark::State& state, int nThreads)
+{
+    std::vector<CBlockHeader> vHeaders(HEADERS_PER_THREAD, MakeBenchHeader(POW_TYPE_X16RT));
+    for (size_t i = 0; i < vHeaders.size(); i++) {
+        vHeaders[i].nNonce = 0xf0000000 + i;
+        vHeaders[i].GetHash();
+    }
+
+    while (state.KeepRunning()) {
+        boost::thread_group tg;
+        for (int t = 0; t < nThreads; t++) {
+            tg.create_thread([&vHeaders] {
+                for (int n = 0; n < 100; n++) {
+                    for (const auto& header : vHeaders) {
+                        header.GetHash();
+                    }
+                }
+            });
+        }
+        tg.join_all();
+    }
+}
+
+// MinotaurX hashing with a scratch area reused across hashes, as done by the
+// miner threads and (through the per-thread scratch area) by validation.
+static void MinotaurXHashReusedScratch(benchmark::State& state)
+{
+    CBlockHeader header = MakeBenchHeader(POW_TYPE_MINOTAURX);
+    CYespowerLocal yespowerLocal;
+    while (state.KeepRunning()) {
+        header.nNonce++;
+        header.ComputePoWHash(yespowerLocal.get());
+    }
+}
+
+// The yespower stage as hashed before the scratch areas were passed in: in the
+// region yespower_tls() keeps per thread, which is never freed.
+static void YespowerTls(benchmark::State& state)
+{
+    uint512 hash;
+    while (state.KeepRunning()) {
+        yespower_tls(hash.begin(), hash.size(), &yespower_params, (yespower_binary_t*)hash.begin());
+    }
+}
+
+// The yespower stage as hashed now, in a scratch area owned by the caller.
+static void YespowerReusedScratch(benchmark::State& state)
+{
+    uint512 hash;
+    CYespowerLocal yespowerLocal;
+    while (state.KeepRunning()) {
+        yespower(yespowerLocal.get(), hash.begin(), hash.size(), &yespower_params, (yespower_binary_t*)hash.begin());
+    }
+}
+
+static void PowHash_1Thread(benchmark::State& state) { PowHashThreads(state, 1); }
+static void PowHash_2Threads(benchmark::State& state) { PowHashThreads(state, 2); }
+static void PowHash_4Threads(benchmark::State& state) { PowHashThreads(state, 4); }
+static void PowHash_8Threads(benchmark::State& state) { PowHashThreads(state, 8); }
+static void PowHashCached_1Thread(benchmark::State& state) { PowHashCachedThreads(state, 1); }
+static void PowHashCached_8Threads(benchmark::State& state) { PowHashCachedThreads(state, 8); }
+
+BENCHMARK(PowHash_1Thread);
+BENCHMARK(PowHash_2Threads);
+BENCHMARK(PowHash_4Threads);
+BENCHMARK(PowHash_8Threads);
+BENCHMARK(PowHashCached_1Thread);
+BENCHMARK(PowHashCached_8Threads);
+BENCHMARK(MinotaurXHashReusedScratch);
+BENCHMARK(YespowerTls);
+BENCHMARK(YespowerReusedScratch);
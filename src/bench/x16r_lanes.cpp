@@ -0,0 +1,157 @@
+// Copyright (c) 2022 The Avian Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+#include "algo/x16r/x16r_midstate.h"
+#include "primitives/block.h"
+
+static void FillLanes(uint512 vHash[X16R_LANES])
+{
+    for (int k = 0; k < X16R_LANES; k++)
+        for (unsigned int i = 0; i < vHash[k].size(); i++)
+            vHash[k].begin()[i] = (unsigned char)(i + k);
+}
+
+// One X16R algorithm applied to X16R_LANES 64 byte intermediate hashes. Uses the
+// multi-lane kernel if X16RMultiAutoDetect() found one for it, else one lane at a time.
+static void X16RLanes(benchmark::State& state, int algo)
+{
+    uint512 vHash[2][X16R_LANES];
+    FillLanes(vHash[0]);
+
+    int n = 0;
+    while (state.KeepRunning()) {
+        X16RHashLanes(algo, vHash[n & 1], vHash[(n + 1) & 1]);
+        n++;
+    }
+}
+
+// The same algorithm and lanes hashed one lane at a time with sphlib, the baseline
+// for X16RLanes. Both take the same time for the stages without a multi-lane kernel.
+static void X16RScalar(benchmark::State& state, int algo)
+{
+    uint512 vHash[2][X16R_LANES];
+    FillLanes(vHash[0]);
+
+    int n = 0;
+    while (state.KeepRunning()) {
+        X16RHashLanesScalar(algo, vHash[n & 1], vHash[(n + 1) & 1]);
+        n++;
+    }
+}
+
+static CBlockHeader MakeBenchHeader(uint32_t nNonce)
+{
+    CBlockHeader header;
+    header.nVersion = 0x20000000;
+    header.hashPrevBlock = uint256S("0x000000000000a9a3ae2a3e6e2b1f6b9d2fbc2a1e7b5a3d6e7f8091a2b3c4d5e6");
+    header.hashMerkleRoot = uint256S("0x4a5e1e4baab89f3a32518a88c31bc87f618f76673e2cc77ab2127b7afdeda33b");
+    header.nTime = 1600000000; // X16R, so hashPrevBlock selects the algorithms
+    header.nBits = 0x1e00ffff;
+    header.nNonce = nNonce;
+    return header;
+}
+
+// Full X16R of X16R_LANES headers, one after the other
+static void X16RHeadersScalar(benchmark::State& state)
+{
+    std::vector<CBlockHeader> vHeaders;
+    for (int k = 0; k < X16R_LANES; k++)
+        vHeaders.push_back(MakeBenchHeader(k));
+
+    while (state.KeepRunning()) {
+        for (CBlockHeader& header : vHeaders) {
+            header.nNonce += X16R_LANES;
+            header.ComputePoWHash();
+        }
+    }
+}
+
+// Full X16R of X16R_LANES headers sharing a selector, in lockstep. Two of the sixteen
+// stages are vectorized, the others run sphlib one lane at a time, so the gain over
+// X16RHeadersScalar is bounded by the share of time spent in BLAKE and Keccak.
+static void X16RHeadersLanes(benchmark::State& state)
+{
+    std::vector<CBlockHeader> vHeaders;
+    const unsigned char* vpData[X16R_LANES];
+    for (int k = 0; k < X16R_LANES; k++)
+        vHeaders.push_back(MakeBenchHeader(k));
+    for (int k = 0; k < X16R_LANES; k++)
+        vpData[k] = (const unsigned char*)&vHeaders[k].nVersion;
+
+    uint256 vHash[X16R_LANES];
+    while (state.KeepRunning()) {
+        for (CBlockHeader& header : vHeaders)
+            header.nNonce += X16R_LANES;
+        HashX16RLanes(vpData, vHeaders[0].hashPrevBlock, vHash);
+    }
+}
+
+static void X16RLanes_Blake(benchmark::State& state) { X16RLanes(state, 0); }
+static void X16RScalar_Blake(benchmark::State& state) { X16RScalar(state, 0); }
+static void X16RLanes_Bmw(benchmark::State& state) { X16RLanes(state, 1); }
+static void X16RScalar_Bmw(benchmark::State& state) { X16RScalar(state, 1); }
+static void X16RLanes_Groestl(benchmark::State& state) { X16RLanes(state, 2); }
+static void X16RScalar_Groestl(benchmark::State& state) { X16RScalar(state, 2); }
+static void X16RLanes_Jh(benchmark::State& state) { X16RLanes(state, 3); }
+static void X16RScalar_Jh(benchmark::State& state) { X16RScalar(state, 3); }
+static void X16RLanes_Keccak(benchmark::State& state) { X16RLanes(state, 4); }
+static void X16RScalar_Keccak(benchmark::State& state) { X16RScalar(state, 4); }
+static void X16RLanes_Skein(benchmark::State& state) { X16RLanes(state, 5); }
+static void X16RScalar_Skein(benchmark::State& state) { X16RScalar(state, 5); }
+static void X16RLanes_Luffa(benchmark::State& state) { X16RLanes(state, 6); }
+static void X16RScalar_Luffa(benchmark::State& state) { X16RScalar(state, 6); }
+static void X16RLanes_Cubehash(benchmark::State& state) { X16RLanes(state, 7); }
+static void X16RScalar_Cubehash(benchmark::State& state) { X16RScalar(state, 7); }
+static void X16RLanes_Shavite(benchmark::State& state) { X16RLanes(state, 8); }
+static void X16RScalar_Shavite(benchmark::State& state) { X16RScalar(state, 8); }
+static void X16RLanes_Simd(benchmark::State& state) { X16RLanes(state, 9); }
+static void X16RScalar_Simd(benchmark::State& state) { X16RScalar(state, 9); }
+static void X16RLanes_Echo(benchmark::State& state) { X16RLanes(state, 10); }
+static void X16RScalar_Echo(benchmark::State& state) { X16RScalar(state, 10); }
+static void X16RLanes_Hamsi(benchmark::State& state) { X16RLanes(state, 11); }
+static void X16RScalar_Hamsi(benchmark::State& state) { X16RScalar(state, 11); }
+static void X16RLanes_Fugue(benchmark::State& state) { X16RLanes(state, 12); }
+static void X16RScalar_Fugue(benchmark::State& state) { X16RScalar(state, 12); }
+static void X16RLanes_Shabal(benchmark::State& state) { X16RLanes(state, 13); }
+static void X16RScalar_Shabal(benchmark::State& state) { X16RScalar(state, 13); }
+static void X16RLanes_Whirlpool(benchmark::State& state) { X16RLanes(state, 14); }
+static void X16RScalar_Whirlpool(benchmark::State& state) { X16RScalar(state, 14); }
+static void X16RLanes_Sha512(benchmark::State& state) { X16RLanes(state, 15); }
+static void X16RScalar_Sha512(benchmark::State& state) { X16RScalar(state, 15); }
+
+BENCHMARK(X16RLanes_Blake);
+BENCHMARK(X16RScalar_Blake);
+BENCHMARK(X16RLanes_Bmw);
+BENCHMARK(X16RScalar_Bmw);
+BENCHMARK(X16RLanes_Groestl);
+BENCHMARK(X16RScalar_Groestl);
+BENCHMARK(X16RLanes_Jh);
+BENCHMARK(X16RScalar_Jh);
+BENCHMARK(X16RLanes_Keccak);
+BENCHMARK(X16RScalar_Keccak);
+BENCHMARK(X16RLanes_Skein);
+BENCHMARK(X16RScalar_Skein);
+BENCHMARK(X16RLanes_Luffa);
+BENCHMARK(X16RScalar_Luffa);
+BENCHMARK(X16RLanes_Cubehash);
+BENCHMARK(X16RScalar_Cubehash);
+BENCHMARK(X16RLanes_Shavite);
+BENCHMARK(X16RScalar_Shavite);
+BENCHMARK(X16RLanes_Simd);
+BENCHMARK(X16RScalar_Simd);
+BENCHMARK(X16RLanes_Echo);
+BENCHMARK(X16RScalar_Echo);
+BENCHMARK(X16RLanes_Hamsi);
+BENCHMARK(X16RScalar_Hamsi);
+BENCHMARK(X16RLanes_Fugue);
+BENCHMARK(X16RScalar_Fugue);
+BENCHMARK(X16RLanes_Shabal);
+BENCHMARK(X16RScalar_Shabal);
+BENCHMARK(X16RLanes_Whirlpool);
+BENCHMARK(X16RScalar_Whirlpool);
+BENCHMARK(X16RLanes_Sha512);
+BENCHMARK(X16RScalar_Sha512);
+BENCHMARK(X16RHeadersScalar);
+BENCHMARK(X16RHeadersLanes);
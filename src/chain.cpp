@@ -126,6 +126,30 @@ void CBlockIndex::BuildSkip()
 {
     if (pprev)
         pskip = pprev->GetAncestor(GetSkipHeight(nHeight));
+
+    // Blocks with an unknown pow type are rejected, don't walk back to genesis looking for another one
+    if (GetPoWType() >= NUM_BLOCK_TYPES) {
+        pprevSameAlgo = nullptr;
+        return;
+    }
+
+    pprevSameAlgo = pprev;
+    while (pprevSameAlgo && pprevSameAlgo->GetPoWType() != GetPoWType())
+        pprevSameAlgo = pprevSameAlgo->pprev;
+}
+
+void CBlockIndex::BuildChainWork()
+{
+    arith_uint256 proof = GetBlockProof(*this);
+    nChainWork = (pprev ? pprev->nChainWork : 0) + proof;
+
+    // Dual Algo: Work counts towards the pow type of the block, all work before the fork is x16rt (as in GetBlockProof with a pow type)
+    int nPoWType = IsDualAlgoEnabled(this, Params().GetConsensus()) ? GetPoWType() : POW_TYPE_X16RT;
+    for (int i = 0; i < NUM_BLOCK_TYPES; i++) {
+        nChainWorkAlgo[i] = pprev ? pprev->nChainWorkAlgo[i] : 0;
+        if (i == nPoWType)
+            nChainWorkAlgo[i] += proof;
+    }
 }
 
 
@@ -140,7 +164,7 @@ arith_uint256 GetBlockProof(const CBlockIndex& block, POW_TYPE powType)
         return 0;
 
     // skip the wrong pow type
-    if (IsDualAlgoEnabled(&block, Params().GetConsensus()) && block.GetBlockHeader().GetPoWType() != powType)
+    if (IsDualAlgoEnabled(&block, Params().GetConsensus()) && block.GetPoWType() != powType)
         return 0;
     //  if you ask for minotaurx hashes before it's enabled, there aren't any!
     if (!IsDualAlgoEnabled(&block, Params().GetConsensus()) && powType == POW_TYPE_MINOTAURX)
@@ -193,6 +193,9 @@ public:
     //! pointer to the index of some further predecessor of this block
     CBlockIndex* pskip;
 
+    //! (memory only) pointer to the index of the nearest predecessor mined with the same pow type as this block
+    CBlockIndex* pprevSameAlgo;
+
     //! height of the entry in the chain. The genesis block has height 0
     int nHeight;
 
@@ -208,6 +211,9 @@ public:
     //! (memory only) Total amount of work (expected number of hashes) in the chain up to and including this block
     arith_uint256 nChainWork;
 
+    //! (memory only) Total amount of work in the chain up to and including this block, split by the pow type it was mined with
+    arith_uint256 nChainWorkAlgo[NUM_BLOCK_TYPES];
+
     //! Number of transactions in this block.
     //! Note: in a potential headers-first mode, this number cannot be relied upon
     unsigned int nTx;
@@ -238,11 +244,14 @@ public:
         phashBlock = nullptr;
         pprev = nullptr;
         pskip = nullptr;
+        pprevSameAlgo = nullptr;
         nHeight = 0;
         nFile = 0;
         nDataPos = 0;
         nUndoPos = 0;
         nChainWork = arith_uint256();
+        for (arith_uint256& work : nChainWorkAlgo)
+            work = arith_uint256();
         nTx = 0;
         nChainTx = 0;
         nStatus = 0;
@@ -315,6 +324,12 @@ public:
         return (int64_t)nTime;
     }
 
+    // Dual Algo: Get pow type from version bits, without building the header
+    POW_TYPE GetPoWType() const
+    {
+        return (POW_TYPE)((nVersion >> 16) & 0xFF);
+    }
+
     int64_t GetBlockTimeMax() const
     {
         return (int64_t)nTimeMax;
@@ -367,9 +382,12 @@ public:
         return false;
     }
 
-    //! Build the skiplist pointer for this entry.
+    //! Build the skiplist pointer and the same pow type pointer for this entry.
     void BuildSkip();
 
+    //! Set the total and per pow type chain work of this entry from its predecessor.
+    void BuildChainWork();
+
     //! Efficiently find an ancestor of this block.
     CBlockIndex* GetAncestor(int height);
     const CBlockIndex* GetAncestor(int height) const;
@@ -10,6 +10,8 @@ extern "C" {
 }
 
 #include "amount.h"
+#include "assets/assetdb.h"
+#include "assets/assets.h"
 #include "base58.h"
 #include "chain.h"
 #include "consensus/validation.h"
@@ -35,6 +37,9 @@ extern "C" {
 #include "wallet/wallet.h"
 #include "wallet/walletdb.h"
 
+#include <climits>
+#include <cstring>
+#include <set>
 #include <string>
 
 #include "lua/lua.hpp"
@@ -279,33 +284,439 @@ bool RPCParse(std::string& strResult, const std::string& strCommand, const bool
     }
 }
 
-/* Call RPC method with multiple arguments */
-int RPCCall(lua_State* L, std::string command)
+/* Message of an exception thrown by an RPC method */
+static std::string RPCErrorMessage(const UniValue& objError)
+{
+    const UniValue& message = find_value(objError, "message");
+    return message.isStr() ? message.get_str() : objError.write();
+}
+
+/* Push a JSON value as the equivalent Lua value */
+static void PushUniValue(lua_State* L, const UniValue& value)
+{
+    luaL_checkstack(L, 2, "Result nested too deeply");
+
+    switch (value.getType()) {
+    case UniValue::VBOOL:
+        lua_pushboolean(L, value.get_bool());
+        break;
+    case UniValue::VNUM:
+        // Keep integers exact, everything else is a float
+        if (value.getValStr().find_first_of(".eE") == std::string::npos)
+            lua_pushinteger(L, value.get_int64());
+        else
+            lua_pushnumber(L, value.get_real());
+        break;
+    case UniValue::VSTR:
+        lua_pushlstring(L, value.get_str().data(), value.get_str().size());
+        break;
+    case UniValue::VARR:
+        lua_createtable(L, value.size(), 0);
+        for (size_t i = 0; i < value.size(); i++) {
+            PushUniValue(L, value[i]);
+            lua_rawseti(L, -2, i + 1);
+        }
+        break;
+    case UniValue::VOBJ:
+        lua_createtable(L, 0, value.size());
+        for (size_t i = 0; i < value.size(); i++) {
+            PushUniValue(L, value[i]);
+            lua_setfield(L, -2, value.getKeys()[i].c_str());
+        }
+        break;
+    default:
+        lua_pushnil(L);
+    }
+}
+
+/* Convert the Lua value at index to JSON, tables with a sequence are arrays. Each nested table takes up to
+ * two more stack slots, which are checked here since a C function is only given LUA_MINSTACK. Throws instead
+ * of raising a Lua error, as the caller holds C++ objects */
+static UniValue ToUniValue(lua_State* L, int index, int depth = 0)
+{
+    if (depth > 32 || !lua_checkstack(L, 2))
+        throw std::runtime_error("Argument nested too deeply");
+
+    index = lua_absindex(L, index);
+    switch (lua_type(L, index)) {
+    case LUA_TBOOLEAN:
+        return UniValue((bool)lua_toboolean(L, index));
+    case LUA_TNUMBER:
+        if (lua_isinteger(L, index))
+            return UniValue((int64_t)lua_tointeger(L, index));
+        return UniValue((double)lua_tonumber(L, index));
+    case LUA_TSTRING:
+        return UniValue(std::string(lua_tostring(L, index)));
+    case LUA_TTABLE: {
+        size_t len = lua_rawlen(L, index);
+        if (len > 0) {
+            UniValue arr(UniValue::VARR);
+            for (size_t i = 1; i <= len; i++) {
+                lua_rawgeti(L, index, i);
+                arr.push_back(ToUniValue(L, -1, depth + 1));
+                lua_pop(L, 1);
+            }
+            return arr;
+        }
+        UniValue obj(UniValue::VOBJ);
+        lua_pushnil(L);
+        while (lua_next(L, index) != 0) {
+            if (lua_type(L, -2) != LUA_TSTRING) {
+                lua_pop(L, 2);
+                throw std::runtime_error("Object keys must be strings");
+            }
+            obj.pushKV(lua_tostring(L, -2), ToUniValue(L, -1, depth + 1));
+            lua_pop(L, 1);
+        }
+        return obj;
+    }
+    case LUA_TNIL:
+        return NullUniValue;
+    default:
+        throw std::runtime_error("Invalid argument");
+    }
+}
+
+/* Push the value in protected mode, so that running out of memory returns here instead of unwinding
+ * past the C++ objects of the caller. Returns false with the error object on the stack if it failed */
+static int protected_push_univalue(lua_State* L)
 {
-    std::string args;
+    PushUniValue(L, *static_cast<const UniValue*>(lua_touserdata(L, 1)));
+    return 1;
+}
 
+static bool SafePushUniValue(lua_State* L, const UniValue& value)
+{
+    lua_pushcfunction(L, protected_push_univalue);
+    lua_pushlightuserdata(L, const_cast<UniValue*>(&value));
+    return lua_pcall(L, 1, 1, 0) == LUA_OK;
+}
+
+/* Call RPC method with multiple arguments */
+int RPCCall(lua_State* L, const char* command)
+{
     /* get number of arguments */
     int n = lua_gettop(L);
 
-    /* loop through each argument */
+    /* check each argument, and convert numbers to strings before any C++ object lives in this frame */
     for (int i = 1; i <= n; i++) {
-        if (lua_isstring(L, i)) {
-            std::string arg = std::string(lua_tostring(L, i));
-            args = args + " " + arg;
+        if (!lua_isstring(L, i))
+            return luaL_error(L, "Invalid argument");
+        lua_tolstring(L, i, nullptr);
+    }
+
+    bool fError = false;
+    {
+        std::vector<std::string> args;
+        for (int i = 1; i <= n; i++) {
+            size_t len;
+            const char* arg = lua_tolstring(L, i, &len);
+            args.emplace_back(arg, len);
+        }
+
+        // Dispatch straight to the method, converting the arguments the way avian-cli does
+        UniValue result;
+        try {
+            JSONRPCRequest req;
+            req.strMethod = command;
+            req.params = RPCConvertValues(command, args);
+            UniValue value = tableRPC.execute(req);
+
+            // don't stringify the json in case of a string to avoid doublequotes
+            result = value.isStr() ? value : UniValue(value.write(2));
+        } catch (const UniValue& objError) {
+            fError = true;
+            result = UniValue(RPCErrorMessage(objError));
+        } catch (const std::exception& e) {
+            fError = true;
+            result = UniValue(std::string(e.what()));
+        }
+
+        if (!SafePushUniValue(L, result))
+            fError = true;
+    }
+
+    // Raise outside of the scope above, lua_error does not unwind C++ objects
+    if (fError)
+        return lua_error(L);
+
+    return 1;
+}
+
+/* Read only RPC methods that avian.data.call may run */
+static const std::set<std::string> setDataCallMethods = {
+    // assets
+    "ansdecode",
+    "ansencode",
+    "getansdata",
+    "getassetdata",
+    "getsnapshot",
+    "listassetbalancesbyaddress",
+    "listassets",
+    // blockchain
+    "getbestblockhash",
+    "getblock",
+    "getblockchaininfo",
+    "getblockcount",
+    "getblockdeltas",
+    "getblockhash",
+    "getblockhashes",
+    "getblockheader",
+    "getblockstats",
+    "getchaintips",
+    "getchaintxstats",
+    "getdifficulty",
+    "getmempoolancestors",
+    "getmempooldescendants",
+    "getmempoolentry",
+    "getmempoolinfo",
+    "getrawmempool",
+    "getspentinfo",
+    "gettxout",
+    "gettxoutproof",
+    "verifytxoutproof",
+    // mining
+    "getmininginfo",
+    "getnetworkhashps",
+    // util
+    "estimatefee",
+    "estimatesmartfee",
+    "getindexinfo",
+    "validateaddress",
+    "verifymessage",
+    // addressindex
+    "getaddressbalance",
+    "getaddressdeltas",
+    "getaddressmempool",
+    "getaddresstxids",
+    "getaddressutxos",
+    // rawtransactions
+    "decoderawtransaction",
+    "decodescript",
+    "getrawtransaction",
+};
+
+/* Call a read only RPC method with typed arguments, returning the result as Lua values */
+static int data_call(lua_State* L)
+{
+    int n = lua_gettop(L);
+    const char* method = luaL_checkstring(L, 1);
+
+    bool fError = false;
+    {
+        UniValue result;
+        try {
+            if (!setDataCallMethods.count(method))
+                throw std::runtime_error(strprintf("Method not available to flight plans: %s", method));
+
+            JSONRPCRequest req;
+            req.strMethod = method;
+            req.params = UniValue(UniValue::VARR);
+            for (int i = 2; i <= n; i++)
+                req.params.push_back(ToUniValue(L, i));
+
+            result = tableRPC.execute(req);
+        } catch (const UniValue& objError) {
+            fError = true;
+            result = UniValue(RPCErrorMessage(objError));
+        } catch (const std::exception& e) {
+            fError = true;
+            result = UniValue(std::string(e.what()));
+        }
+
+        if (!SafePushUniValue(L, result))
+            fError = true;
+    }
+
+    if (fError)
+        return lua_error(L);
+
+    return 1;
+}
+
+/* The functions below read what they need under cs_main into C++ objects, then release the lock
+ * before pushing anything: a Lua error unwinds with longjmp, which would leave the lock held */
+
+// Metadata of the asset from the asset cache, nil if it doesn't exist. Amounts are in satoshis
+static int data_assetdata(lua_State* L)
+{
+    const char* asset_name = luaL_checkstring(L, 1);
+
+    bool fPushed;
+    {
+        UniValue data(UniValue::VOBJ);
+        {
+            LOCK(cs_main);
+            auto currentActiveAssetCache = GetCurrentAssetCache();
+            CNewAsset asset;
+            if (currentActiveAssetCache && currentActiveAssetCache->GetAssetMetaDataIfExists(asset_name, asset)) {
+                data.pushKV("name", asset.strName);
+                data.pushKV("amount", (int64_t)asset.nAmount);
+                data.pushKV("units", (int)asset.units);
+                data.pushKV("reissuable", (bool)asset.nReissuable);
+                data.pushKV("has_ipfs", (bool)asset.nHasIPFS);
+                data.pushKV("has_ans", (bool)asset.nHasANS);
+
+                if (asset.nHasIPFS)
+                    data.pushKV(asset.strIPFSHash.size() == 32 ? "txid" : "ipfs_hash", EncodeAssetData(asset.strIPFSHash));
+
+                if (asset.nHasANS)
+                    data.pushKV("ans_id", asset.strANSID);
+
+                CNullAssetTxVerifierString verifier;
+                if (currentActiveAssetCache->GetAssetVerifierStringIfExists(asset.strName, verifier))
+                    data.pushKV("verifier_string", verifier.verifier_string);
+            }
+        }
+
+        if (data.empty()) {
+            lua_pushnil(L);
+            fPushed = true;
         } else {
-            lua_pushliteral(L, "Invalid argument");
-            lua_error(L);
+            fPushed = SafePushUniValue(L, data);
         }
     }
 
-    std::string result;
-    if (RPCParse(result, command + args, true, nullptr)) {
-        lua_pushstring(L, result.c_str());
-    } else {
-        lua_pushliteral(L, "RPC Parse error: unbalanced ' or \"");
-        lua_error(L);
+    if (!fPushed)
+        return lua_error(L);
+
+    return 1;
+}
+
+// Page of the holders of an asset as address -> amount in satoshis, and the address to continue after (nil at the end).
+// Reads the asset database, so changes still in the asset cache show up once it is flushed
+static int data_assetholders(lua_State* L)
+{
+    const char* asset_name = luaL_checkstring(L, 1);
+    lua_Integer count = luaL_optinteger(L, 2, 50000);
+    const char* after_address = luaL_optstring(L, 3, "");
+
+    if (!fAssetIndex)
+        return luaL_error(L, "Not functional unless -assetindex is enabled");
+    if (count < 1)
+        return luaL_error(L, "count must be at least 1.");
+
+    bool fFound;
+    bool fPushed = false;
+    {
+        std::vector<std::pair<std::string, CAmount>> vecAddressAmounts;
+        std::string next_address;
+        {
+            LOCK(cs_main);
+            fFound = passetsdb && passetsdb->AssetAddressDirFrom(vecAddressAmounts, asset_name, after_address, count, next_address);
+        }
+
+        if (fFound) {
+            UniValue holders(UniValue::VOBJ);
+            for (const auto& pair : vecAddressAmounts)
+                holders.pushKV(pair.first, (int64_t)pair.second);
+
+            UniValue page(UniValue::VARR);
+            page.push_back(holders);
+            if (!next_address.empty())
+                page.push_back(next_address);
+
+            fPushed = SafePushUniValue(L, page);
+        }
+    }
+
+    if (!fFound)
+        return luaL_error(L, "couldn't retrieve address asset directory.");
+    if (!fPushed)
+        return lua_error(L);
+
+    // Return the page as two results, without the table around them
+    lua_rawgeti(L, -1, 1);
+    lua_rawgeti(L, -2, 2);
+    lua_remove(L, -3);
+    return 2;
+}
+
+// Asset balances of an address as asset name -> amount in satoshis
+static int data_addressbalances(lua_State* L)
+{
+    const char* address = luaL_checkstring(L, 1);
+
+    if (!fAssetIndex)
+        return luaL_error(L, "Not functional unless -assetindex is enabled");
+
+    bool fValid;
+    bool fFound = false;
+    bool fPushed = false;
+    {
+        std::vector<std::pair<std::string, CAmount>> vecAssetAmounts;
+        int nTotalEntries = 0;
+
+        fValid = IsValidDestination(DecodeDestination(address));
+        if (fValid) {
+            LOCK(cs_main);
+            fFound = passetsdb && passetsdb->AddressDir(vecAssetAmounts, nTotalEntries, false, address, INT_MAX, 0);
+        }
+
+        if (fFound) {
+            UniValue balances(UniValue::VOBJ);
+            for (const auto& pair : vecAssetAmounts)
+                balances.pushKV(pair.first, (int64_t)pair.second);
+
+            fPushed = SafePushUniValue(L, balances);
+        }
     }
 
+    if (!fValid)
+        return luaL_error(L, "Invalid Avian address: %s", address);
+    if (!fFound)
+        return luaL_error(L, "couldn't retrieve address asset directory.");
+    if (!fPushed)
+        return lua_error(L);
+
+    return 1;
+}
+
+// Height of the active chain
+static int data_blockcount(lua_State* L)
+{
+    int nHeight;
+    {
+        LOCK(cs_main);
+        nHeight = chainActive.Height();
+    }
+
+    lua_pushinteger(L, nHeight);
+    return 1;
+}
+
+// Hash of the active chain block at height, nil if out of range
+static int data_blockhash(lua_State* L)
+{
+    lua_Integer height = luaL_checkinteger(L, 1);
+
+    bool fFound = false;
+    char hash[65];
+    {
+        LOCK(cs_main);
+        if (height >= 0 && height <= chainActive.Height()) {
+            strncpy(hash, chainActive[height]->GetBlockHash().GetHex().c_str(), sizeof(hash));
+            fFound = true;
+        }
+    }
+
+    if (!fFound)
+        lua_pushnil(L);
+    else
+        lua_pushlstring(L, hash, 64);
+    return 1;
+}
+
+// Hash of the tip of the active chain
+static int data_bestblockhash(lua_State* L)
+{
+    char hash[65];
+    {
+        LOCK(cs_main);
+        strncpy(hash, chainActive.Tip()->GetBlockHash().GetHex().c_str(), sizeof(hash));
+    }
+
+    lua_pushlstring(L, hash, 64);
     return 1;
 }
 
@@ -1045,6 +1456,16 @@ void register_avianlib(lua_State* L)
         {"ansdecode", ansdecode},
         {NULL, NULL}};
 
+    static const struct luaL_Reg avian_data[] = {
+        {"call", data_call},
+        {"assetdata", data_assetdata},
+        {"assetholders", data_assetholders},
+        {"addressbalances", data_addressbalances},
+        {"blockcount", data_blockcount},
+        {"blockhash", data_blockhash},
+        {"bestblockhash", data_bestblockhash},
+        {NULL, NULL}};
+
     static const struct luaL_Reg avian_blockchain[] = {
         {"decodeblock", decodeblock},
         {"getbestblockhash", getbestblockhash},
@@ -1189,6 +1610,10 @@ void register_avianlib(lua_State* L)
     luaL_setfuncs(L, avian_wallet, 0);
     lua_setfield(L, -2, "localWallet");
 
+    lua_newtable(L);
+    luaL_setfuncs(L, avian_data, 0);
+    lua_setfield(L, -2, "data");
+
     lua_setglobal(L, "avian"); // assign the avian table to global `avian`
 
     lua_cjson(L);
@@ -11,88 +11,499 @@ Please take precautions when using this feature.
 #include "flightplans.h"
 
 #include "avianlib.h"
+#include "fs.h"
+#include "sync.h"
 #include "util.h"
+#include "utiltime.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdio>
+#include <cstdlib>
+#include <ctime>
 #include <iostream>
 #include <string>
 
 #include "lua/lua.hpp"
 
-FlightPlanResult AvianFlightPlans::run_file(const char* file, const char* func, std::vector<std::string> args)
+namespace {
+
+/* Number of idle Lua states kept warm for each flight plan */
+static const size_t MAX_IDLE_STATES = 4;
+
+/* Number of Lua instructions between two checks of the limits */
+static const int METER_INSTRUCTION_STEP = 1000;
+
+/* Resources used by a Lua state, and the limits of the call it runs */
+struct FlightPlanMeter
 {
-    /* Warn user **/
-    LogPrintf("Running flight plan -- Avian Flight Plans are experimental and prone to bugs. Please take precautions when using this feature.\n");
+    size_t memory = 0;      // bytes currently allocated
+    size_t memory_peak = 0;
+    size_t max_memory = 0;  // 0 for no limit
+    int64_t instructions = 0;
+    int64_t max_instructions = 0;
+    int64_t deadline = 0;   // GetTimeMillis() after which the call is aborted, 0 for none
+};
 
-    // Result object
-    FlightPlanResult result;
-    int status;
+/* lua_Alloc that accounts for the memory of the state and fails past its limit */
+void* metered_alloc(void* ud, void* ptr, size_t osize, size_t nsize)
+{
+    FlightPlanMeter* meter = static_cast<FlightPlanMeter*>(ud);
+
+    // osize is the type of the object instead of a size when ptr is NULL
+    if (!ptr)
+        osize = 0;
+
+    if (nsize == 0) {
+        free(ptr);
+        meter->memory -= osize;
+        return nullptr;
+    }
+
+    if (meter->max_memory && nsize > osize && meter->memory - osize + nsize > meter->max_memory)
+        return nullptr;
+
+    void* block = realloc(ptr, nsize);
+    if (block) {
+        meter->memory = meter->memory - osize + nsize;
+        meter->memory_peak = std::max(meter->memory_peak, meter->memory);
+    }
+    return block;
+}
+
+FlightPlanMeter* get_meter(lua_State* L)
+{
+    void* ud;
+    lua_getallocf(L, &ud);
+    return static_cast<FlightPlanMeter*>(ud);
+}
+
+/* Count hook aborting the call once it is over its instruction budget or time */
+void meter_hook(lua_State* L, lua_Debug* ar)
+{
+    FlightPlanMeter* meter = get_meter(L);
+    meter->instructions += METER_INSTRUCTION_STEP;
+
+    if (meter->max_instructions && meter->instructions > meter->max_instructions)
+        luaL_error(L, "Flight plan exceeded its instruction limit of %I", (lua_Integer)meter->max_instructions);
+
+    if (meter->deadline && GetTimeMillis() > meter->deadline)
+        luaL_error(L, "Flight plan exceeded its time limit");
+}
+
+void close_state(lua_State* L)
+{
+    FlightPlanMeter* meter = get_meter(L);
+    lua_close(L);
+    delete meter;
+}
+
+/* A Lua state with the libraries registered and the flight plan loaded */
+struct FlightPlanState
+{
+    lua_State* L = nullptr;
+    int chunk_ref = LUA_NOREF; // registry reference to the loaded chunk
+    uint64_t generation = 0;   // the compilation the chunk came from
+};
+
+/* Compiled chunk and warm states of one flight plan file */
+struct FlightPlanPool
+{
+    std::time_t mtime = 0;
+    uintmax_t size = 0;
+    uint64_t generation = 0;
+    std::string bytecode; // the chunk as dumped by lua_dump, so new states load it without parsing
+    std::vector<FlightPlanState> idle;
+    FlightPlanStats stats;
+
+    FlightPlanPool() = default;
+    FlightPlanPool(const FlightPlanPool&) = delete;
+    FlightPlanPool& operator=(const FlightPlanPool&) = delete;
+
+    void clear_idle()
+    {
+        for (auto& state : idle)
+            close_state(state.L);
+        idle.clear();
+    }
+
+    ~FlightPlanPool() { clear_idle(); }
+};
+
+CCriticalSection cs_flightplans;
+std::map<std::string, FlightPlanPool> mapFlightPlanPools;
 
+int write_bytecode(lua_State* L, const void* p, size_t sz, void* ud)
+{
+    static_cast<std::string*>(ud)->append(static_cast<const char*>(p), sz);
+    return 0;
+}
+
+/* The error object on top of the stack, which is not always a string */
+std::string error_message(lua_State* L)
+{
+    const char* message = lua_tostring(L, -1);
+    return message ? message : "Error object is not a string.";
+}
+
+/* Registry fields of the sandbox the calls of a state run in */
+const char* const SANDBOX_GLOBALS = "avian.sandbox.globals";   // the globals as registered
+const char* const SANDBOX_ENV_META = "avian.sandbox.env_meta"; // metatable of the globals of a call
+
+int readonly_newindex(lua_State* L)
+{
+    return luaL_error(L, "attempt to modify a read only table");
+}
+
+/* Replace the table on top of the stack with a read only proxy of it. The tables it holds, like the
+ * categories of avian, are proxied as well. Proxies are userdata so that rawset can't change them either */
+void make_readonly(lua_State* L, int depth = 0)
+{
+    int table = lua_gettop(L);
+
+    if (depth < 2) {
+        lua_pushnil(L);
+        while (lua_next(L, table) != 0) {
+            if (lua_type(L, -1) == LUA_TTABLE && !lua_rawequal(L, -1, table)) {
+                make_readonly(L, depth + 1);
+                lua_pushvalue(L, -2);
+                lua_insert(L, -2);
+                lua_rawset(L, table);
+            } else {
+                lua_pop(L, 1);
+            }
+        }
+    }
+
+    lua_newuserdata(L, 0);
+    lua_createtable(L, 0, 3);
+    lua_pushvalue(L, table);
+    lua_setfield(L, -2, "__index");
+    lua_pushcfunction(L, readonly_newindex);
+    lua_setfield(L, -2, "__newindex");
+    lua_pushboolean(L, 0);
+    lua_setfield(L, -2, "__metatable");
+    lua_setmetatable(L, -2);
+    lua_replace(L, table);
+}
+
+/* Set up the sandbox of the state, once the libraries are registered. Runs in protected mode */
+int build_sandbox(lua_State* L)
+{
+    // Strings reach the string library through their metatable, keep it out of reach
+    lua_pushliteral(L, "");
+    lua_getmetatable(L, -1);
+    lua_pushboolean(L, 0);
+    lua_setfield(L, -2, "__metatable");
+    lua_pop(L, 2);
+
+    lua_pushglobaltable(L);
+    lua_setfield(L, LUA_REGISTRYINDEX, SANDBOX_GLOBALS);
+
+    // Calls see the globals read only, each in globals of its own falling back on them
+    lua_createtable(L, 0, 2);
+    lua_pushglobaltable(L);
+    lua_pushnil(L);
+    lua_setfield(L, -2, "_G");
+    make_readonly(L);
+    lua_setfield(L, -2, "__index");
+    lua_pushboolean(L, 0);
+    lua_setfield(L, -2, "__metatable");
+    lua_setfield(L, LUA_REGISTRYINDEX, SANDBOX_ENV_META);
+    return 0;
+}
+
+/* Parse the file into bytecode, returns false with the error message in result otherwise */
+bool compile_file(const char* file, std::string& bytecode, FlightPlanResult& result)
+{
     lua_State* L = luaL_newstate();
 
+    if (luaL_loadfile(L, file) != LUA_OK) {
+        result.result = error_message(L);
+        result.is_error = true;
+        lua_close(L);
+        return false;
+    }
+
+    bytecode.clear();
+    lua_dump(L, write_bytecode, &bytecode, 0);
+    lua_close(L);
+    return true;
+}
+
+/* Create a state ready to run the compiled flight plan */
+bool new_state(const char* file, const std::string& bytecode, uint64_t generation, FlightPlanState& state, FlightPlanResult& result)
+{
+    lua_State* L = lua_newstate(metered_alloc, new FlightPlanMeter());
+    if (!L) {
+        result.result = "Not enough memory to create the flight plan state.";
+        result.is_error = true;
+        return false;
+    }
+
     // Make standard libraries available in the Lua object
-    luaopen_base(L);
-    luaopen_table(L);
-    luaopen_string(L);
-    luaopen_math(L);
+    luaL_requiref(L, "_G", luaopen_base, 1);
+    luaL_requiref(L, LUA_TABLIBNAME, luaopen_table, 1);
+    luaL_requiref(L, LUA_STRLIBNAME, luaopen_string, 1);
+    luaL_requiref(L, LUA_MATHLIBNAME, luaopen_math, 1);
+    lua_settop(L, 0);
 
     // Register Avian lib
     register_avianlib(L);
+    lua_settop(L, 0);
 
-    // Load the program
-    status = luaL_dofile(L, file);
+    // Calls only ever see the globals through read only proxies
+    lua_pushcfunction(L, build_sandbox);
+    if (lua_pcall(L, 0, 0, 0) != LUA_OK) {
+        result.result = error_message(L);
+        result.is_error = true;
+        close_state(L);
+        return false;
+    }
 
-    if (status != LUA_OK) {
-        const char* message = lua_tostring(L, -1);
-        result.result = message;
+    // Load the program from its bytecode
+    std::string chunkname = std::string("@") + file;
+    if (luaL_loadbufferx(L, bytecode.data(), bytecode.size(), chunkname.c_str(), "b") != LUA_OK) {
+        result.result = error_message(L);
         result.is_error = true;
-        lua_pop(L, 1);
-        return result;
+        close_state(L);
+        return false;
     }
 
-    // The function name
-    lua_getglobal(L, func);
+    state.L = L;
+    state.chunk_ref = luaL_ref(L, LUA_REGISTRYINDEX);
+    state.generation = generation;
+    return true;
+}
+
+/* Take a warm state for the file, compiling it first if it is new or changed on disk */
+bool acquire_state(const char* file, FlightPlanState& state, FlightPlanResult& result)
+{
+    boost::system::error_code ec;
+    std::time_t mtime = fs::last_write_time(file, ec);
+    if (ec) {
+        result.result = std::string("cannot open ") + file;
+        result.is_error = true;
+        return false;
+    }
+    uintmax_t size = fs::file_size(file, ec);
+    if (ec) {
+        result.result = std::string("cannot read ") + file;
+        result.is_error = true;
+        return false;
+    }
 
-    if (lua_isfunction(L, -1)) {
-        int n = 0;
+    bool fCompile;
+    {
+        LOCK(cs_flightplans);
+        const FlightPlanPool& pool = mapFlightPlanPools[file];
+        fCompile = pool.bytecode.empty() || pool.mtime != mtime || pool.size != size;
+    }
 
-        if (args.size() >= 1) {
-            n = args.size();
-            /* loop through each argument */
-            for (int i = 0; i < n; i++) {
-                /* push argument */
-                lua_pushstring(L, args[i].c_str());
-            }
+    // Parse outside of the lock, so that calls of other flight plans don't wait for it
+    std::string bytecode;
+    if (fCompile && !compile_file(file, bytecode, result))
+        return false;
+
+    uint64_t generation;
+    {
+        LOCK(cs_flightplans);
+        FlightPlanPool& pool = mapFlightPlanPools[file];
+
+        // Unless another call installed this version of the file in the meantime
+        if (fCompile && (pool.bytecode.empty() || pool.mtime != mtime || pool.size != size)) {
+            if (!pool.bytecode.empty())
+                pool.stats.reloads++;
+            pool.bytecode = bytecode;
+            pool.mtime = mtime;
+            pool.size = size;
+            pool.generation++;
+            pool.clear_idle();
         }
 
-        /* call the function with n arguments, return 1 result */
-        status = lua_pcall(L, n, 1, 0);
+        if (!pool.idle.empty()) {
+            state = pool.idle.back();
+            pool.idle.pop_back();
+            return true;
+        }
 
-        if (status != LUA_OK) {
-            const char* message = lua_tostring(L, -1);
-            result.result = message;
-            result.is_error = true;
-            lua_pop(L, 1);
-            return result;
+        bytecode = pool.bytecode;
+        generation = pool.generation;
+    }
+
+    return new_state(file, bytecode, generation, state, result);
+}
+
+/* Give the state back to the pool, unless the flight plan was reloaded in the meantime */
+void release_state(const char* file, const FlightPlanState& state)
+{
+    lua_settop(state.L, 0);
+
+    {
+        LOCK(cs_flightplans);
+        FlightPlanPool& pool = mapFlightPlanPools[file];
+        if (state.generation == pool.generation && pool.idle.size() < MAX_IDLE_STATES) {
+            pool.idle.push_back(state);
+            return;
         }
+    }
 
+    close_state(state.L);
+}
+
+/* A flight plan function call, passed to protected_call */
+struct FlightPlanCall
+{
+    int chunk_ref;
+    const char* func;
+    const std::vector<std::string>* args;
+};
+
+/* Run the flight plan and its function, returns no result if the function is not found.
+ * Runs in protected mode, so that hitting a limit anywhere is a Lua error */
+int protected_call(lua_State* L)
+{
+    const FlightPlanCall* call = static_cast<const FlightPlanCall*>(lua_touserdata(L, 1));
+
+    // Fresh globals for every call, falling back on read only proxies of the libraries
+    lua_newtable(L);
+    lua_getfield(L, LUA_REGISTRYINDEX, SANDBOX_ENV_META);
+    lua_setmetatable(L, -2);
+    lua_pushvalue(L, -1);
+    lua_setfield(L, -2, "_G");
+
+    // They are the globals of the state for the call, so that load and its chunks use them too
+    lua_pushvalue(L, -1);
+    lua_rawseti(L, LUA_REGISTRYINDEX, LUA_RIDX_GLOBALS);
+
+    // Run the program in them, its first upvalue is _ENV
+    lua_rawgeti(L, LUA_REGISTRYINDEX, call->chunk_ref);
+    lua_pushvalue(L, -2);
+    lua_setupvalue(L, -2, 1);
+    lua_call(L, 0, 0);
+
+    // The function name
+    lua_getfield(L, -1, call->func);
+
+    if (!lua_isfunction(L, -1))
+        return 0;
+
+    /* loop through each argument */
+    int n = call->args->size();
+    for (int i = 0; i < n; i++) {
+        /* push argument */
+        lua_pushstring(L, (*call->args)[i].c_str());
+    }
+
+    /* call the function with n arguments, return 1 result */
+    lua_call(L, n, 1);
+    return 1;
+}
+
+/* Run the function of the flight plan loaded in L, within the configured limits */
+FlightPlanResult run_function(lua_State* L, int chunk_ref, const char* func, const std::vector<std::string>& args)
+{
+    FlightPlanResult result;
+    FlightPlanCall call{chunk_ref, func, &args};
+
+    // Meter the call
+    FlightPlanMeter* meter = get_meter(L);
+    int64_t timeout = gArgs.GetArg("-flightplantimeout", DEFAULT_FLIGHTPLAN_TIMEOUT);
+    meter->max_memory = std::max<int64_t>(0, gArgs.GetArg("-flightplanmaxmemory", DEFAULT_FLIGHTPLAN_MAX_MEMORY)) << 20;
+    meter->max_instructions = std::max<int64_t>(0, gArgs.GetArg("-flightplanmaxinstructions", DEFAULT_FLIGHTPLAN_MAX_INSTRUCTIONS));
+    meter->deadline = timeout > 0 ? GetTimeMillis() + timeout : 0;
+    meter->instructions = 0;
+    meter->memory_peak = meter->memory;
+    lua_sethook(L, meter_hook, LUA_MASKCOUNT, METER_INSTRUCTION_STEP);
+
+    lua_settop(L, 0);
+    lua_pushcfunction(L, protected_call);
+    lua_pushlightuserdata(L, &call);
+    int status = lua_pcall(L, 1, LUA_MULTRET, 0);
+
+    // Don't keep the globals of the call alive
+    lua_getfield(L, LUA_REGISTRYINDEX, SANDBOX_GLOBALS);
+    lua_rawseti(L, LUA_REGISTRYINDEX, LUA_RIDX_GLOBALS);
+
+    // Lift the limits before reading the results, which may allocate
+    lua_sethook(L, nullptr, 0, 0);
+    meter->max_memory = 0;
+    meter->max_instructions = 0;
+    meter->deadline = 0;
+
+    result.instructions = meter->instructions;
+    result.memory_peak = meter->memory_peak;
+
+    if (status == LUA_ERRMEM) {
+        result.result = "Flight plan exceeded its memory limit";
+        result.is_error = true;
+    } else if (status != LUA_OK) {
+        result.result = error_message(L);
+        result.is_error = true;
+    } else if (lua_gettop(L) == 0) {
+        result.result = "Function not found or invalid.";
+        result.is_error = true;
+    } else if (lua_isstring(L, -1)) {
         /* get the result */
-        if (lua_isstring(L, -1)) {
-            result.result = (char*)lua_tostring(L, -1);
-            lua_pop(L, 1);
-        } else {
-            result.result = "Return value was null.";
-            result.is_error = true;
-            return result;
-        }
+        result.result = lua_tostring(L, -1);
     } else {
-        result.result = "Function not found or invalid.";
+        result.result = "Return value was null.";
         result.is_error = true;
-        return result;
     }
 
-    lua_close(L);
+    // Don't leave what an aborted call allocated to the next one
+    if (result.is_error)
+        lua_gc(L, LUA_GCCOLLECT);
+
+    return result;
+}
+
+} // namespace
+
+FlightPlanResult AvianFlightPlans::run_file(const char* file, const char* func, std::vector<std::string> args)
+{
+    /* Warn user **/
+    LogPrintf("Running flight plan -- Avian Flight Plans are experimental and prone to bugs. Please take precautions when using this feature.\n");
+
+    int64_t nTimeStart = GetTimeMicros();
+
+    // Result object
+    FlightPlanResult result;
+    FlightPlanState state;
+
+    if (acquire_state(file, state, result)) {
+        result = run_function(state.L, state.chunk_ref, func, args);
+        release_state(file, state);
+    }
+
+    int64_t nTimeCall = GetTimeMicros() - nTimeStart;
+    result.micros = nTimeCall;
+    LogPrint(BCLog::RPC, "Flight plan %s %s: %dus, %d instructions, %u bytes peak memory%s\n", file, func, nTimeCall, result.instructions, result.memory_peak, result.is_error ? ", failed" : "");
+
+    LOCK(cs_flightplans);
+    auto it = mapFlightPlanPools.find(file);
+    if (it != mapFlightPlanPools.end()) {
+        FlightPlanStats& stats = it->second.stats;
+        stats.calls++;
+        if (result.is_error)
+            stats.errors++;
+        stats.total_micros += nTimeCall;
+        stats.max_micros = std::max(stats.max_micros, nTimeCall);
+        stats.last_micros = nTimeCall;
+        stats.max_instructions = std::max(stats.max_instructions, result.instructions);
+        stats.max_memory = std::max(stats.max_memory, result.memory_peak);
+    }
 
     return result;
 }
+
+std::map<std::string, FlightPlanStats> AvianFlightPlans::get_stats()
+{
+    std::map<std::string, FlightPlanStats> stats;
+
+    LOCK(cs_flightplans);
+    for (const auto& pool : mapFlightPlanPools)
+        stats.emplace(pool.first, pool.second.stats);
+
+    return stats;
+}
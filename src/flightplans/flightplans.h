@@ -6,15 +6,41 @@
 #ifndef AVIAN_FLIGHTPLANS_H
 #define AVIAN_FLIGHTPLANS_H
 
+#include <map>
+#include <stdint.h>
 #include <string>
 #include <vector>
 
+/* Default limits of a flight plan call, 0 disables a limit */
+static const int64_t DEFAULT_FLIGHTPLAN_MAX_INSTRUCTIONS = 100000000;
+static const int64_t DEFAULT_FLIGHTPLAN_MAX_MEMORY = 64; // MiB
+static const int64_t DEFAULT_FLIGHTPLAN_TIMEOUT = 10000; // milliseconds
+
 /* Avian Flightplans Result */
 class FlightPlanResult
 {
 public:
-    const char* result;
+    std::string result;
     bool is_error = false;
+
+    /* Resources used by the call */
+    int64_t instructions = 0; // Lua VM instructions, counted in steps of 1000
+    size_t memory_peak = 0;   // bytes allocated by the Lua state at most
+    int64_t micros = 0;       // time the call took
+};
+
+/* Avian Flightplans call statistics */
+class FlightPlanStats
+{
+public:
+    uint64_t calls = 0;
+    uint64_t errors = 0;
+    uint64_t reloads = 0;
+    int64_t total_micros = 0;
+    int64_t max_micros = 0;
+    int64_t last_micros = 0;
+    int64_t max_instructions = 0;
+    size_t max_memory = 0;
 };
 
 /* Avian Flightplans */
@@ -22,6 +48,9 @@ class AvianFlightPlans
 {
 public:
     FlightPlanResult run_file(const char* file, const char* func, std::vector<std::string> args={});
+
+    /* Call statistics of every flight plan run so far, by file */
+    static std::map<std::string, FlightPlanStats> get_stats();
 };
 
 #endif
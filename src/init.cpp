@@ -11,6 +11,7 @@
 #include "init.h"
 
 #include "addrman.h"
+#include "algo/x16r/x16r_multi.h"
 #include "amount.h"
 #include "assets/assetdb.h"
 #include "assets/assets.h"
@@ -20,6 +21,7 @@
 #include "checkpoints.h"
 #include "compat/sanity.h"
 #include "consensus/validation.h"
+#include "flightplans/flightplans.h"
 #include "fs.h"
 #include "httprpc.h"
 #include "httpserver.h"
@@ -39,6 +41,7 @@
 #include "scheduler.h"
 #include "script/sigcache.h"
 #include "script/standard.h"
+#include "taskqueue.h"
 #include "timedata.h"
 #include "torcontrol.h"
 #include "txdb.h"
@@ -612,6 +615,7 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-blockmaxweight=<n>", strprintf(_("Set maximum BIP141 block weight (default: %d)"), MAX_BLOCK_WEIGHT - 4000));
     strUsage += HelpMessageOpt("-blockmaxsize=<n>", _("Set maximum BIP141 block weight to this * 4. Deprecated, use blockmaxweight"));
     strUsage += HelpMessageOpt("-blockmintxfee=<amt>", strprintf(_("Set lowest fee rate (in %s/kB) for transactions to be included in block creation. (default: %s)"), CURRENCY_UNIT, FormatMoney(DEFAULT_BLOCK_MIN_TX_FEE)));
+    strUsage += HelpMessageOpt("-fastblocktemplate", strprintf(_("Skip the full validity test of new block templates that change no restricted asset state, relying on the checks done when their transactions entered the mempool (default: %u)"), DEFAULT_FAST_BLOCK_TEMPLATE));
     if (showDebug)
         strUsage += HelpMessageOpt("-blockversion=<n>", "Override block version to test forking scenarios");
 
@@ -638,6 +642,9 @@ std::string HelpMessage(HelpMessageMode mode)
         strUsage += HelpMessageOpt("-powcachevalidate", _("Enable/disable PoW cache validation (default: disabled)"));
     // Flightplan: Show how to enable flightplans
     strUsage += HelpMessageOpt("-flightplans", strprintf(_("Enable Avian Flightplans for use via JSON-RPC")));
+    strUsage += HelpMessageOpt("-flightplanmaxinstructions=<n>", strprintf(_("Abort flight plan calls after <n> Lua instructions, 0 for no limit (default: %d)"), DEFAULT_FLIGHTPLAN_MAX_INSTRUCTIONS));
+    strUsage += HelpMessageOpt("-flightplanmaxmemory=<n>", strprintf(_("Limit the memory of a flight plan to <n> MiB, 0 for no limit (default: %d)"), DEFAULT_FLIGHTPLAN_MAX_MEMORY));
+    strUsage += HelpMessageOpt("-flightplantimeout=<n>", strprintf(_("Abort flight plan calls running for more than <n> milliseconds, 0 for no limit (default: %d)"), DEFAULT_FLIGHTPLAN_TIMEOUT));
     return strUsage;
 }
 
@@ -1306,6 +1313,8 @@ bool AppInitSanityChecks()
     // Initialize elliptic curve code
     std::string sha256_algo = SHA256AutoDetect();
     LogPrintf("Using the '%s' SHA256 implementation\n", sha256_algo);
+    std::string x16r_algo = X16RMultiAutoDetect();
+    LogPrintf("Using the '%s' multi-lane X16R implementation\n", x16r_algo);
     RandomInit();
     ECC_Start();
     globalVerifyHandle.reset(new ECCVerifyHandle());
@@ -1362,8 +1371,17 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
     if (nScriptCheckThreads) {
         for (int i = 0; i < nScriptCheckThreads - 1; i++)
             threadGroup.create_thread(&ThreadScriptCheck);
+        for (int i = 0; i < nScriptCheckThreads - 1; i++)
+            threadGroup.create_thread(&ThreadHeaderPoWCheck);
     }
 
+    nTaskQueueThreads = std::min(GetNumCores(), MAX_TASK_QUEUE_THREADS);
+    if (nTaskQueueThreads <= 1)
+        nTaskQueueThreads = 0;
+    LogPrintf("Using %u threads for the task queue\n", nTaskQueueThreads);
+    for (int i = 0; i < nTaskQueueThreads - 1; i++)
+        threadGroup.create_thread(&ThreadTaskQueue);
+
     // Start the lightweight task scheduler thread
     CScheduler::Function serviceLoop = boost::bind(&CScheduler::serviceQueue, &scheduler);
     threadGroup.create_thread(boost::bind(&TraceThread<CScheduler::Function>, "scheduler", serviceLoop));
@@ -1542,6 +1560,8 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
     int64_t nBlockTreeDBCache = nTotalCache / 8;
     nBlockTreeDBCache = std::min(nBlockTreeDBCache, (gArgs.GetBoolArg("-txindex", DEFAULT_TXINDEX) ? nMaxBlockDBAndTxIndexCache : nMaxBlockDBCache) << 20);
     nTotalCache -= nBlockTreeDBCache;
+    int64_t nAssetMetaDataCache = std::min(nTotalCache / 32, nMaxAssetMetaDataCache << 20);
+    nTotalCache -= nAssetMetaDataCache;
     int64_t nCoinDBCache = std::min(nTotalCache / 2, (nTotalCache / 4) + (1 << 23)); // use 25%-50% of the remainder for disk cache
     nCoinDBCache = std::min(nCoinDBCache, nMaxCoinsDBCache << 20);                   // cap total coins db cache
     nTotalCache -= nCoinDBCache;
@@ -1550,6 +1570,7 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
     LogPrintf("Cache configuration:\n");
     LogPrintf("* Using %.1fMiB for block index database\n", nBlockTreeDBCache * (1.0 / 1024 / 1024));
     LogPrintf("* Using %.1fMiB for chain state database\n", nCoinDBCache * (1.0 / 1024 / 1024));
+    LogPrintf("* Using %.1fMiB for asset metadata cache\n", nAssetMetaDataCache * (1.0 / 1024 / 1024));
     LogPrintf("* Using %.1fMiB for in-memory UTXO set (plus up to %.1fMiB of unused mempool space)\n", nCoinCacheUsage * (1.0 / 1024 / 1024), nMempoolSizeMax * (1.0 / 1024 / 1024));
 
     bool fLoaded = false;
@@ -1599,7 +1620,7 @@ bool AppInitMain(boost::thread_group& threadGroup, CScheduler& scheduler)
                     // Basic assets
                     passetsdb = new CAssetsDB(nBlockTreeDBCache, false, fReset);
                     passets = new CAssetsCache();
-                    passetsCache = new CLRUCache<std::string, CDatabasedAssetData>(MAX_CACHE_ASSETS_SIZE);
+                    passetsCache = new CAssetMetaDataCache(nAssetMetaDataCache);
 
                     // Messaging assets
                     pMessagesCache = new CLRUCache<std::string, CMessage>(1000);
@@ -12,6 +12,7 @@
 
 #include <map>
 #include <set>
+#include <string>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
@@ -87,6 +88,13 @@ static inline size_t DynamicUsage(const std::vector<X>& v)
     return MallocUsage(v.capacity() * sizeof(X));
 }
 
+static inline size_t DynamicUsage(const std::string& s)
+{
+    // Strings that fit the inline buffer of the short string optimization don't allocate
+    static const size_t nInlineCapacity = std::string().capacity();
+    return s.capacity() > nInlineCapacity ? MallocUsage(s.capacity() + 1) : 0;
+}
+
 template<unsigned int N, typename X, typename S, typename D>
 static inline size_t DynamicUsage(const prevector<N, X, S, D>& v)
 {
@@ -7,6 +7,8 @@
 
 #include "miner.h"
 
+#include "algo/x16r/x16r_midstate.h"
+
 #include "amount.h"
 #include "chain.h"
 #include "chainparams.h"
@@ -34,11 +36,13 @@
 
 
 #include <algorithm>
+#include <boost/bind/bind.hpp>
 #include <boost/core/ref.hpp>
 #include <boost/thread.hpp>
 #include <queue>
 #include <utility>
 
+using namespace boost::placeholders;
 
 extern std::vector<CWalletRef> vpwallets;
 //////////////////////////////////////////////////////////////////////////////
@@ -78,10 +82,40 @@ int64_t UpdateTime(CBlockHeader* pblock, const Consensus::ConsensusParams& conse
     return nNewTime - nOldTime;
 }
 
+void UpdatePoWType(CBlockHeader* pblock, const CChainParams& chainparams, const CBlockIndex* pindexPrev, const POW_TYPE powType)
+{
+    const Consensus::ConsensusParams& consensusParams = chainparams.GetConsensus();
+
+    pblock->nVersion = ComputeBlockVersion(pindexPrev, consensusParams);
+
+    // Dual Algo: If Minotaurx Algo is enabled, encode desired pow type.
+    if (IsDualAlgoEnabled(pindexPrev, consensusParams)) {
+        if (powType >= NUM_BLOCK_TYPES)
+            throw std::runtime_error("Error: Unrecognised pow type requested");
+        pblock->nVersion |= powType << 16;
+    } else if (powType != POW_TYPE_X16RT) {
+        throw std::runtime_error("Error: Won't attempt to create a non-x16r block before Dual Algo activation");
+    }
+
+    // -regtest only: allow overriding block.nVersion with
+    // -blockversion=N to test forking scenarios
+    if (chainparams.MineBlocksOnDemand())
+        pblock->nVersion = gArgs.GetArg("-blockversion", pblock->nVersion);
+
+    UpdateTime(pblock, consensusParams, pindexPrev, powType);
+
+    if (IsDualAlgoEnabled(pindexPrev, consensusParams)) {
+        pblock->nBits = GetNextWorkRequiredLWMA(pindexPrev, pblock, consensusParams, powType);
+    } else {
+        pblock->nBits = GetNextWorkRequired(pindexPrev, pblock, consensusParams);
+    }
+}
+
 BlockAssembler::Options::Options()
 {
     blockMinFeeRate = CFeeRate(DEFAULT_BLOCK_MIN_TX_FEE);
     nBlockMaxWeight = GetMaxBlockWeight() - 4000;
+    fFastTemplate = DEFAULT_FAST_BLOCK_TEMPLATE;
 }
 
 BlockAssembler::BlockAssembler(const CChainParams& params, const Options& options) : chainparams(params)
@@ -89,6 +123,7 @@ BlockAssembler::BlockAssembler(const CChainParams& params, const Options& option
     blockMinFeeRate = options.blockMinFeeRate;
     // Limit weight to between 4K and MAX_BLOCK_WEIGHT-4K for sanity:
     nBlockMaxWeight = std::max<size_t>(4000, std::min<size_t>(GetMaxBlockWeight() - 4000, options.nBlockMaxWeight));
+    fFastTemplate = options.fFastTemplate;
 }
 
 static BlockAssembler::Options DefaultOptions(const CChainParams& params)
@@ -106,6 +141,7 @@ static BlockAssembler::Options DefaultOptions(const CChainParams& params)
     } else {
         options.blockMinFeeRate = CFeeRate(DEFAULT_BLOCK_MIN_TX_FEE);
     }
+    options.fFastTemplate = gArgs.GetBoolArg("-fastblocktemplate", DEFAULT_FAST_BLOCK_TEMPLATE);
     return options;
 }
 
@@ -123,6 +159,12 @@ void BlockAssembler::resetBlock()
     // These counters do not include coinbase tx
     nBlockTx = 0;
     nFees = 0;
+
+    setAssetsIssued.clear();
+    setAssetsReissued.clear();
+    setAssetsGlobalRestricted.clear();
+    setAddressAssetsRestricted.clear();
+    fRestrictedAssetsChanged = false;
 }
 
 // Dual Algo: Accept POW_TYPE arg
@@ -148,24 +190,10 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
     assert(pindexPrev != nullptr);
     nHeight = pindexPrev->nHeight + 1;
 
-    pblock->nVersion = ComputeBlockVersion(pindexPrev, chainparams.GetConsensus());
-
     // Dual Algo: Refuse to attempt to create a non-x16r block before activation
     if (!IsDualAlgoEnabled(pindexPrev, chainparams.GetConsensus()) && powType != 0)
         throw std::runtime_error("Error: Won't attempt to create a non-x16r block before Dual Algo activation");
 
-    // Dual Algo: If Minotaurx Algo is enabled, encode desired pow type.
-    if (IsDualAlgoEnabled(pindexPrev, chainparams.GetConsensus())) {
-        if (powType >= NUM_BLOCK_TYPES)
-            throw std::runtime_error("Error: Unrecognised pow type requested");
-        pblock->nVersion |= powType << 16;
-    }
-
-    // -regtest only: allow overriding block.nVersion with
-    // -blockversion=N to test forking scenarios
-    if (chainparams.MineBlocksOnDemand())
-        pblock->nVersion = gArgs.GetArg("-blockversion", pblock->nVersion);
-
     pblock->nTime = GetAdjustedTime();
     const int64_t nMedianTimePast = pindexPrev->GetMedianTimePast();
 
@@ -185,6 +213,44 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
 
     int64_t nTime1 = GetTimeMicros();
 
+    FinishBlock(scriptPubKeyIn, pindexPrev, powType);
+
+    int64_t nTime2 = GetTimeMicros();
+
+    LogPrint(BCLog::BENCH, "CreateNewBlock() packages: %.2fms (%d packages, %d updated descendants), validity: %.2fms (total %.2fms)\n", 0.001 * (nTime1 - nTimeStart), nPackagesSelected, nDescendantsUpdated, 0.001 * (nTime2 - nTime1), 0.001 * (nTime2 - nTimeStart));
+
+    return std::move(pblocktemplate);
+}
+
+/** The checks of TestBlockValidity on what the assembly itself produced, for templates whose transactions
+  * aren't replayed against the tip: the coinbase, its founder payment and the block's weight and sigops */
+static bool TestBlockAssembly(CValidationState& state, const CBlock& block, const CChainParams& chainparams, int nHeight, CAmount nFees, int64_t nSigOpsCost)
+{
+    if (block.vtx.empty() || !block.vtx[0]->IsCoinBase())
+        return state.DoS(100, false, REJECT_INVALID, "bad-cb-missing", false, "first tx is not coinbase");
+    for (unsigned int i = 1; i < block.vtx.size(); i++)
+        if (block.vtx[i]->IsCoinBase())
+            return state.DoS(100, false, REJECT_INVALID, "bad-cb-multiple", false, "more than one coinbase");
+
+    CAmount blockReward = nFees + GetBlockSubsidy(nHeight, chainparams.GetConsensus());
+    if (block.vtx[0]->GetValueOut(AreEnforcedValuesDeployed()) > blockReward)
+        return state.DoS(100, false, REJECT_INVALID, "bad-cb-amount", false, "coinbase pays too much");
+
+    FounderPayment founderPayment = chainparams.GetConsensus().nFounderPayment;
+    CAmount founderReward = founderPayment.getFounderPaymentAmount(nHeight, blockReward);
+    if (nHeight > founderPayment.getStartBlock() && founderReward && !founderPayment.IsBlockPayeeValid(*block.vtx[0], nHeight, blockReward))
+        return state.DoS(0, false, REJECT_INVALID, "bad-cb-payee", false, "couldn't find founders fee payments");
+
+    if (GetBlockWeight(block) > GetMaxBlockWeight())
+        return state.DoS(100, false, REJECT_INVALID, "bad-blk-weight", false, "weight limit failed");
+    if (nSigOpsCost > (int64_t)MAX_BLOCK_SIGOPS_COST)
+        return state.DoS(100, false, REJECT_INVALID, "bad-blk-sigops", false, "too many sigops");
+
+    return true;
+}
+
+void BlockAssembler::FinishBlock(const CScript& scriptPubKeyIn, CBlockIndex* pindexPrev, const POW_TYPE powType)
+{
     nLastBlockTx = nBlockTx;
     nLastBlockWeight = nBlockWeight;
 
@@ -211,26 +277,102 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const CScript& sc
 
     // Fill in header
     pblock->hashPrevBlock = pindexPrev->GetBlockHash();
-    UpdateTime(pblock, chainparams.GetConsensus(), pindexPrev, powType);
-
-    if (IsDualAlgoEnabled(pindexPrev, chainparams.GetConsensus())) {
-        pblock->nBits = GetNextWorkRequiredLWMA(pindexPrev, pblock, chainparams.GetConsensus(), powType);
-    } else {
-        pblock->nBits = GetNextWorkRequired(pindexPrev, pblock, chainparams.GetConsensus());
-    }
-
+    UpdatePoWType(pblock, chainparams, pindexPrev, powType);
     pblock->nNonce = 0;
     pblocktemplate->vTxSigOpsCost[0] = WITNESS_SCALE_FACTOR * GetLegacySigOpCount(*pblock->vtx[0]);
 
+    // Every transaction was checked against the tip when it entered the mempool, and the mempool is kept
+    // consistent with the tip. Only transactions depending on restricted asset state changed earlier in
+    // the same block can be invalid, so the full replay is needed only when the block changes that state.
     CValidationState state;
-    if (!TestBlockValidity(state, chainparams, *pblock, pindexPrev, false, false)) {
-        throw std::runtime_error(strprintf("%s: TestBlockValidity failed: %s", __func__, FormatStateMessage(state)));
+    if (fFastTemplate && !fRestrictedAssetsChanged) {
+        if (!TestBlockAssembly(state, *pblock, chainparams, nHeight, nFees, nBlockSigOpsCost))
+            throw std::runtime_error(strprintf("CreateNewBlock: TestBlockAssembly failed: %s", FormatStateMessage(state)));
+        LogPrint(BCLog::BENCH, "CreateNewBlock(): skipped replaying the transactions, no restricted asset state changed\n");
+    } else if (!TestBlockValidity(state, chainparams, *pblock, pindexPrev, false, false)) {
+        throw std::runtime_error(strprintf("CreateNewBlock: TestBlockValidity failed: %s", FormatStateMessage(state)));
+    }
+}
+
+bool BlockAssembler::UpdateBlock(std::unique_ptr<CBlockTemplate>& pblocktemplateIn, const std::vector<uint256>& vNewTx, const CScript& scriptPubKeyIn, const POW_TYPE powType, bool& fFull)
+{
+    int64_t nTimeStart = GetTimeMicros();
+    fFull = false;
+
+    LOCK2(cs_main, mempool.cs);
+    CBlockIndex* pindexPrev = chainActive.Tip();
+    assert(pindexPrev != nullptr);
+    if (pblocktemplateIn->block.hashPrevBlock != pindexPrev->GetBlockHash())
+        return false;
+
+    // Look the block's transactions up again, mempool iterators of removed entries are gone
+    inBlock.clear();
+    const std::vector<CTransactionRef>& vtx = pblocktemplateIn->block.vtx;
+    for (size_t i = 1; i < vtx.size(); i++) {
+        CTxMemPool::txiter it = mempool.mapTx.find(vtx[i]->GetHash());
+        if (it == mempool.mapTx.end())
+            return false;
+        inBlock.insert(it);
+    }
+
+    pblocktemplate = std::move(pblocktemplateIn);
+    pblock = &pblocktemplate->block;
+
+    // Packages are appended in the order their transactions entered the mempool, parents first.
+    // The block stays valid, but the fee ordering of a full assembly is only restored by the next one.
+    int nPackagesSelected = 0;
+    uint64_t nNoLimit = std::numeric_limits<uint64_t>::max();
+    std::string dummy;
+    for (const uint256& hash : vNewTx) {
+        CTxMemPool::txiter it = mempool.mapTx.find(hash);
+        if (it == mempool.mapTx.end() || inBlock.count(it))
+            continue;
+
+        CTxMemPool::setEntries ancestors;
+        mempool.CalculateMemPoolAncestors(*it, ancestors, nNoLimit, nNoLimit, nNoLimit, nNoLimit, dummy, false);
+        onlyUnconfirmed(ancestors);
+        ancestors.insert(it);
+
+        uint64_t packageSize = 0;
+        CAmount packageFees = 0;
+        int64_t packageSigOpsCost = 0;
+        for (CTxMemPool::txiter ancestor : ancestors) {
+            packageSize += ancestor->GetTxSize();
+            packageFees += ancestor->GetModifiedFee();
+            packageSigOpsCost += ancestor->GetSigOpCost();
+        }
+
+        // A descendant paying for it may still bring it in
+        if (packageFees < blockMinFeeRate.GetFee(packageSize))
+            continue;
+
+        if (!TestPackage(packageSize, packageSigOpsCost)) {
+            fFull = true;
+            continue;
+        }
+
+        if (!TestPackageTransactions(ancestors) || !TestPackageAssets(ancestors))
+            continue;
+
+        std::vector<CTxMemPool::txiter> sortedEntries;
+        SortForBlock(ancestors, it, sortedEntries);
+        for (CTxMemPool::txiter entry : sortedEntries)
+            AddToBlock(entry);
+
+        ++nPackagesSelected;
     }
+
+    int64_t nTime1 = GetTimeMicros();
+
+    if (nPackagesSelected > 0)
+        FinishBlock(scriptPubKeyIn, pindexPrev, powType);
+
     int64_t nTime2 = GetTimeMicros();
 
-    LogPrint(BCLog::BENCH, "CreateNewBlock() packages: %.2fms (%d packages, %d updated descendants), validity: %.2fms (total %.2fms)\n", 0.001 * (nTime1 - nTimeStart), nPackagesSelected, nDescendantsUpdated, 0.001 * (nTime2 - nTime1), 0.001 * (nTime2 - nTimeStart));
+    LogPrint(BCLog::BENCH, "UpdateBlock() packages: %.2fms (%d new txs, %d packages), validity: %.2fms (total %.2fms)\n", 0.001 * (nTime1 - nTimeStart), vNewTx.size(), nPackagesSelected, 0.001 * (nTime2 - nTime1), 0.001 * (nTime2 - nTimeStart));
 
-    return std::move(pblocktemplate);
+    pblocktemplateIn = std::move(pblocktemplate);
+    return true;
 }
 
 void BlockAssembler::onlyUnconfirmed(CTxMemPool::setEntries& testSet)
@@ -270,6 +412,61 @@ bool BlockAssembler::TestPackageTransactions(const CTxMemPool::setEntries& packa
     return true;
 }
 
+bool BlockAssembler::TestPackageAssets(const CTxMemPool::setEntries& package)
+{
+    std::set<std::string> setIssued;
+    std::set<std::string> setReissued;
+    std::set<std::string> setGlobalRestricted;
+    std::set<std::pair<std::string, std::string>> setAddressRestricted;
+    bool fRestrictedChanged = false;
+
+    for (const CTxMemPool::txiter it : package) {
+        for (const CTxOut& out : it->GetTx().vout) {
+            if (out.scriptPubKey.IsAssetScript()) {
+                CAssetOutputEntry data;
+                if (!GetAssetData(out.scriptPubKey, data))
+                    continue;
+
+                if (data.type == TX_NEW_ASSET) {
+                    if (setAssetsIssued.count(data.assetName) || !setIssued.insert(data.assetName).second)
+                        return false;
+                    fRestrictedChanged |= IsAssetNameAnRestricted(data.assetName);
+                } else if (data.type == TX_REISSUE_ASSET) {
+                    if (setAssetsReissued.count(data.assetName) || !setReissued.insert(data.assetName).second)
+                        return false;
+                    fRestrictedChanged |= IsAssetNameAnRestricted(data.assetName);
+                }
+            } else if (out.scriptPubKey.IsNullGlobalRestrictionAssetTxDataScript()) {
+                CNullAssetTxData globalNullData;
+                if (GlobalAssetNullDataFromScript(out.scriptPubKey, globalNullData)) {
+                    if (setAssetsGlobalRestricted.count(globalNullData.asset_name) || !setGlobalRestricted.insert(globalNullData.asset_name).second)
+                        return false;
+                }
+                fRestrictedChanged = true;
+            } else if (out.scriptPubKey.IsNullAssetTxDataScript()) {
+                CNullAssetTxData addressNullData;
+                std::string address;
+                if (AssetNullDataFromScript(out.scriptPubKey, addressNullData, address)) {
+                    auto pair = std::make_pair(address, addressNullData.asset_name);
+                    if (setAddressAssetsRestricted.count(pair) || !setAddressRestricted.insert(pair).second)
+                        return false;
+                }
+                fRestrictedChanged = true;
+            } else if (out.scriptPubKey.IsNullAssetVerifierTxDataScript()) {
+                fRestrictedChanged = true;
+            }
+        }
+    }
+
+    // This is the last check before the package is added
+    setAssetsIssued.insert(setIssued.begin(), setIssued.end());
+    setAssetsReissued.insert(setReissued.begin(), setReissued.end());
+    setAssetsGlobalRestricted.insert(setGlobalRestricted.begin(), setGlobalRestricted.end());
+    setAddressAssetsRestricted.insert(setAddressRestricted.begin(), setAddressRestricted.end());
+    fRestrictedAssetsChanged |= fRestrictedChanged;
+    return true;
+}
+
 void BlockAssembler::AddToBlock(CTxMemPool::txiter iter)
 {
     pblock->vtx.emplace_back(iter->GetSharedTx());
@@ -461,6 +658,15 @@ void BlockAssembler::addPackageTxs(int& nPackagesSelected, int& nDescendantsUpda
             continue;
         }
 
+        // Test if the package conflicts with asset state changed by the block, last as it records the package's
+        if (!TestPackageAssets(ancestors)) {
+            if (fUsingModified) {
+                mapModifiedTx.get<ancestor_score>().erase(modit);
+                failedTx.insert(iter);
+            }
+            continue;
+        }
+
         // This transaction will make it in; reset the failed counter.
         nConsecutiveFailed = 0;
 
@@ -481,6 +687,86 @@ void BlockAssembler::addPackageTxs(int& nPackagesSelected, int& nDescendantsUpda
     }
 }
 
+CBlockTemplateCache::CBlockTemplateCache(const CChainParams& params, const CScript& scriptPubKeyIn) : chainparams(params), assembler(params), scriptPubKey(scriptPubKeyIn), fLastMineWitnessTx(false), nLastRebuild(0), fRebuild(true)
+{
+    mempool.NotifyEntryAdded.connect(boost::bind(&CBlockTemplateCache::TransactionAdded, this, _1));
+    mempool.NotifyEntryRemoved.connect(boost::bind(&CBlockTemplateCache::TransactionRemoved, this, _1, _2));
+}
+
+CBlockTemplateCache::~CBlockTemplateCache()
+{
+    mempool.NotifyEntryAdded.disconnect(boost::bind(&CBlockTemplateCache::TransactionAdded, this, _1));
+    mempool.NotifyEntryRemoved.disconnect(boost::bind(&CBlockTemplateCache::TransactionRemoved, this, _1, _2));
+}
+
+void CBlockTemplateCache::TransactionAdded(CTransactionRef ptx)
+{
+    LOCK(cs);
+    if (fRebuild)
+        return;
+    if (vNewTx.size() >= MAX_BLOCK_TEMPLATE_PENDING_TXS) {
+        fRebuild = true;
+        vNewTx.clear();
+        return;
+    }
+    vNewTx.push_back(ptx->GetHash());
+}
+
+void CBlockTemplateCache::TransactionRemoved(CTransactionRef ptx, MemPoolRemovalReason reason)
+{
+    LOCK(cs);
+    if (!fRebuild && setBlockTx.count(ptx->GetHash())) {
+        fRebuild = true;
+        vNewTx.clear();
+    }
+}
+
+std::unique_ptr<CBlockTemplate> CBlockTemplateCache::GetBlockTemplate(bool fMineWitnessTx, const POW_TYPE powType)
+{
+    // The mempool signals are sent with mempool.cs held
+    LOCK2(cs_main, mempool.cs);
+    LOCK(cs);
+
+    CBlockIndex* pindexPrev = chainActive.Tip();
+    if (!pblocktemplate || pblocktemplate->block.hashPrevBlock != pindexPrev->GetBlockHash() || fLastMineWitnessTx != fMineWitnessTx)
+        fRebuild = true;
+
+    bool fChanged = false;
+    if (!fRebuild && !vNewTx.empty()) {
+        bool fFull = false;
+        if (!assembler.UpdateBlock(pblocktemplate, vNewTx, scriptPubKey, powType, fFull))
+            fRebuild = true;
+        else if (fFull && GetTime() - nLastRebuild > BLOCK_TEMPLATE_REBUILD_INTERVAL)
+            fRebuild = true;
+        vNewTx.clear();
+        fChanged = true;
+    }
+
+    if (fRebuild) {
+        // Leave the candidate empty if assembling it throws, so the next call tries again
+        pblocktemplate.reset();
+        setBlockTx.clear();
+        vNewTx.clear();
+        pblocktemplate = assembler.CreateNewBlock(scriptPubKey, fMineWitnessTx, powType);
+        if (!pblocktemplate)
+            return nullptr;
+        fLastMineWitnessTx = fMineWitnessTx;
+        nLastRebuild = GetTime();
+        fRebuild = false;
+        fChanged = true;
+    }
+
+    if (fChanged) {
+        const std::vector<CTransactionRef>& vtx = pblocktemplate->block.vtx;
+        for (size_t i = 1; i < vtx.size(); i++)
+            setBlockTx.insert(vtx[i]->GetHash());
+    }
+
+    std::unique_ptr<CBlockTemplate> pblocktemplateCopy(new CBlockTemplate(*pblocktemplate));
+    UpdatePoWType(&pblocktemplateCopy->block, chainparams, pindexPrev, powType);
+    return pblocktemplateCopy;
+}
+
 void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned int& nExtraNonce)
 {
     // Update nExtraNonce
@@ -543,6 +829,8 @@ void static AvianMiner(const CChainParams& chainparams, const POW_TYPE powType)
 
     unsigned int nExtraNonce = 0;
 
+    // Keep the MinotaurX scratch memory for the lifetime of this miner thread
+    CYespowerLocal yespowerLocal;
 
     CWallet* pWallet = NULL;
 
@@ -622,9 +910,34 @@ void static AvianMiner(const CChainParams& chainparams, const POW_TYPE powType)
             int64_t nStart = GetTime();
             arith_uint256 hashTarget = arith_uint256().SetCompact(pblock->nBits);
             while (true) {
+                // X16R(T): hash the fixed header fields once, then only the nonce per attempt.
+                // Rebuilt every pass since UpdateTime() may have changed nTime.
+                CX16RMidstate midstate;
+                uint256 hashSelector;
+                if (pblock->GetX16RSelectorHash(hashSelector))
+                    midstate.Init((const unsigned char*)&pblock->nVersion, hashSelector);
+
+                // X16R_LANES consecutive nonces are hashed at once by the multi-lane kernels
+                uint256 vLaneHash[X16R_LANES];
+                uint32_t nLanesBase = 0;
+                bool fLanesValid = false;
+
                 uint256 hash;
                 while (true) {
-                    hash = pblock->ComputePoWHash();
+                    if (midstate.IsInitialized()) {
+                        uint32_t nLane = pblock->nNonce % X16R_LANES;
+                        if (!fLanesValid || nLanesBase != pblock->nNonce - nLane) {
+                            nLanesBase = pblock->nNonce - nLane;
+                            uint32_t vNonce[X16R_LANES];
+                            for (int k = 0; k < X16R_LANES; k++)
+                                vNonce[k] = nLanesBase + k;
+                            midstate.HashLanes(vNonce, vLaneHash);
+                            fLanesValid = true;
+                        }
+                        hash = vLaneHash[nLane];
+                    } else {
+                        hash = pblock->ComputePoWHash(yespowerLocal.get());
+                    }
                     if (UintToArith256(hash) <= hashTarget) {
                         // Found a solution
                         SetThreadPriority(THREAD_PRIORITY_NORMAL);
@@ -9,6 +9,8 @@
 #define AVIAN_MINER_H
 
 #include "primitives/block.h"
+#include "script/script.h"
+#include "sync.h"
 #include "txmempool.h"
 
 #include <stdint.h>
@@ -18,11 +20,15 @@
 
 class CBlockIndex;
 class CChainParams;
-class CScript;
 
 namespace Consensus { struct ConsensusParams; };
 
 static const bool DEFAULT_PRINTPRIORITY = false;
+static const bool DEFAULT_FAST_BLOCK_TEMPLATE = false;
+/** Minimum number of seconds between two full assemblies of the getblocktemplate candidate block */
+static const int64_t BLOCK_TEMPLATE_REBUILD_INTERVAL = 5;
+/** Maximum number of mempool additions queued for the candidate block before it is assembled again instead */
+static const size_t MAX_BLOCK_TEMPLATE_PENDING_TXS = 10000;
 
 struct CBlockTemplate
 {
@@ -151,6 +157,16 @@ private:
     CAmount nFees;
     CTxMemPool::setEntries inBlock;
 
+    // Asset state the block changes, to keep conflicting asset transactions out of it
+    std::set<std::string> setAssetsIssued;
+    std::set<std::string> setAssetsReissued;
+    std::set<std::string> setAssetsGlobalRestricted;
+    std::set<std::pair<std::string, std::string>> setAddressAssetsRestricted;
+    bool fRestrictedAssetsChanged;
+
+    // Skip TestBlockValidity when no transaction in the block depends on restricted asset state it changes
+    bool fFastTemplate;
+
     // Chain context for the block
     int nHeight;
     int64_t nLockTimeCutoff;
@@ -161,6 +177,7 @@ public:
         Options();
         size_t nBlockMaxWeight;
         CFeeRate blockMinFeeRate;
+        bool fFastTemplate;
     };
 
     explicit BlockAssembler(const CChainParams& params);
@@ -168,12 +185,19 @@ public:
 
     /** Construct a new block template with coinbase to scriptPubKeyIn */
      std::unique_ptr<CBlockTemplate> CreateNewBlock(const CScript& scriptPubKeyIn, bool fMineWitnessTx=true, const POW_TYPE powType=POW_TYPE_X16RT);
-private:
+    /** Add the packages of the given new mempool transactions to a template returned by the last
+      * CreateNewBlock call, and finish it again with coinbase to scriptPubKeyIn. Returns false if the
+      * template has to be created again: the tip changed or one of its transactions left the mempool.
+      * fFull is set if a package didn't fit in the block. */
+    bool UpdateBlock(std::unique_ptr<CBlockTemplate>& pblocktemplateIn, const std::vector<uint256>& vNewTx, const CScript& scriptPubKeyIn, const POW_TYPE powType, bool& fFull);
+protected:
     // utility functions
     /** Clear the block's state and prepare for assembling a new block */
     void resetBlock();
     /** Add a tx to the block */
     void AddToBlock(CTxMemPool::txiter iter);
+    /** Create the coinbase, fill in the header and check the block */
+    void FinishBlock(const CScript& scriptPubKeyIn, CBlockIndex* pindexPrev, const POW_TYPE powType);
 
     // Methods for how to add transactions to a block.
     /** Add transactions based on feerate including unconfirmed ancestors
@@ -191,6 +215,10 @@ private:
       * These checks should always succeed, and they're here
       * only as an extra check in case of suboptimal node configuration */
     bool TestPackageTransactions(const CTxMemPool::setEntries& package);
+    /** Check that the package doesn't issue, reissue, freeze or tag anything the block already does,
+      * and record the asset state it changes. Transactions in the mempool never conflict like this, so
+      * this is an extra check in case of races with the mempool */
+    bool TestPackageAssets(const CTxMemPool::setEntries& package);
     /** Return true if given transaction from mapTx has already been evaluated,
       * or if the transaction's cached data in mapTx is incorrect. */
     bool SkipMapTxEntry(CTxMemPool::txiter it, indexed_modified_transaction_set &mapModifiedTx, CTxMemPool::setEntries &failedTx);
@@ -202,9 +230,48 @@ private:
     int UpdatePackagesForAdded(const CTxMemPool::setEntries& alreadyAdded, indexed_modified_transaction_set &mapModifiedTx);
 };
 
+/**
+ * Candidate block kept up to date for getblocktemplate.
+ * Transactions entering the mempool are added to the candidate together with
+ * their unconfirmed ancestors instead of assembling the whole block again.
+ * The candidate is assembled from scratch when the tip changes or one of its
+ * transactions leaves the mempool, and at most every
+ * BLOCK_TEMPLATE_REBUILD_INTERVAL seconds when new packages don't fit in it.
+ * All pow types are served from the same candidate; only the header differs.
+ */
+class CBlockTemplateCache
+{
+private:
+    CCriticalSection cs;
+    const CChainParams& chainparams;
+    BlockAssembler assembler;
+    const CScript scriptPubKey;
+
+    std::unique_ptr<CBlockTemplate> pblocktemplate;
+    std::set<uint256> setBlockTx;
+    bool fLastMineWitnessTx;
+    int64_t nLastRebuild;
+
+    // Mempool changes since the candidate was last updated
+    std::vector<uint256> vNewTx;
+    bool fRebuild;
+
+    void TransactionAdded(CTransactionRef ptx);
+    void TransactionRemoved(CTransactionRef ptx, MemPoolRemovalReason reason);
+
+public:
+    CBlockTemplateCache(const CChainParams& params, const CScript& scriptPubKeyIn);
+    ~CBlockTemplateCache();
+
+    /** Bring the candidate up to date and return a copy of it for the given pow type */
+    std::unique_ptr<CBlockTemplate> GetBlockTemplate(bool fMineWitnessTx, const POW_TYPE powType);
+};
+
 /** Modify the extranonce in a block */
 void IncrementExtraNonce(CBlock* pblock, const CBlockIndex* pindexPrev, unsigned int& nExtraNonce);
 int64_t UpdateTime(CBlockHeader* pblock, const Consensus::ConsensusParams& consensusParams, const CBlockIndex* pindexPrev, const POW_TYPE powType);
+/** Set the version, time and target of a block header for the given pow type */
+void UpdatePoWType(CBlockHeader* pblock, const CChainParams& chainparams, const CBlockIndex* pindexPrev, const POW_TYPE powType);
 
 int GenerateAvians(bool fGenerate, int nThreads, const CChainParams& chainparams);
 #endif // AVIAN_MINER_H
@@ -1205,6 +1205,11 @@ void static ProcessAssetGetData(CNode* pfrom, const Consensus::ConsensusParams&
     const CNetMsgMaker msgMaker(pfrom->GetSendVersion());
     LOCK(cs_main);
 
+    // Peers that know assetdatas get all the assets they asked for in one message
+    bool fBatch = pfrom->GetSendVersion() >= ASSETDATA_BATCH_VERSION;
+    std::vector<SerializedAssetData> vAssetData;
+    auto currentActiveAssetCache = GetCurrentAssetCache();
+
     while (it != pfrom->vRecvAssetGetData.end()) {
         // Don't bother if send buffer is too full to respond anyway
         if (pfrom->fPauseSend)
@@ -1222,32 +1227,26 @@ void static ProcessAssetGetData(CNode* pfrom, const Consensus::ConsensusParams&
                 continue;
             }
 
-            bool push = false;
-            auto currentActiveAssetCache = GetCurrentAssetCache();
             if (currentActiveAssetCache) {
-                CNewAsset asset;
-                int height;
-                uint256 hash;
-                if (currentActiveAssetCache->GetAssetMetaDataIfExists(inv.name, asset, height, hash)) {
-                    auto data = CDatabasedAssetData(asset, height, hash);
-                    passetsCache->Put(inv.name, data);
-                    connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::ASSETDATA, SerializedAssetData(data)));
-                    push = true;
-                } else {
-                    CDatabasedAssetData data;
+                CDatabasedAssetData data;
+                if (!currentActiveAssetCache->GetAssetMetaDataIfExists(inv.name, data.asset, data.nHeight, data.blockHash)) {
+                    data.SetNull();
                     data.asset.strName = "_NF"; // Return _NF for NOT Found
-                    connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::ASSETDATA, SerializedAssetData(data)));
                 }
-            }
 
-            //            if (!push) {
-            //                vNotFound.push_back(inv);
-            //            }
+                if (fBatch)
+                    vAssetData.emplace_back(data);
+                else
+                    connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::ASSETDATA, SerializedAssetData(data)));
+            }
         }
     }
 
     pfrom->vRecvAssetGetData.erase(pfrom->vRecvAssetGetData.begin(), it);
 
+    if (!vAssetData.empty())
+        connman->PushMessage(pfrom, msgMaker.Make(NetMsgType::ASSETDATAS, vAssetData));
+
     //    if (!vNotFound.empty()) {
     //        // Let the peer know that we didn't find what it asked for, so it doesn't
     //        // have to wait around forever. Currently only SPV clients actually care
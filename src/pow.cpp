@@ -11,6 +11,7 @@
 #include "chain.h"
 #include "chainparams.h"
 #include "primitives/block.h"
+#include "sync.h"
 #include "tinyformat.h"
 #include "uint256.h"
 #include "util.h"
@@ -186,13 +187,13 @@ unsigned int GetNextWorkRequiredLWMA1(const CBlockIndex* pindexLast, const CBloc
     const CBlockIndex* blockPreviousTimestamp = pindexLast;
     while (blocksFound < N) {
         // Reached forkpoint before finding N blocks of correct powtype? Return min
-        if (blockPreviousTimestamp->GetBlockHeader().nTime < params.powForkTime) {
+        if (blockPreviousTimestamp->nTime < params.powForkTime) {
             if (verbose) LogPrintf("* GetNextWorkRequiredLWMA1: Allowing %s pow limit (previousTime calc reached forkpoint at height %i)\n", POW_TYPE_NAMES[powType], blockPreviousTimestamp->nHeight);
             return powLimit.GetCompact();
         }
 
         // Wrong block type? Skip
-        if (blockPreviousTimestamp->GetBlockHeader().GetPoWType() != powType) {
+        if (blockPreviousTimestamp->GetPoWType() != powType) {
             assert(blockPreviousTimestamp->pprev);
             blockPreviousTimestamp = blockPreviousTimestamp->pprev;
             continue;
@@ -212,7 +213,7 @@ unsigned int GetNextWorkRequiredLWMA1(const CBlockIndex* pindexLast, const CBloc
     blocksFound = 0;
     while (blocksFound < N) {
         // Wrong block type? Skip
-        if (pindexLast->GetBlockHeader().GetPoWType() != powType) {
+        if (pindexLast->GetPoWType() != powType) {
             // if (verbose) LogPrintf("* GetNextWorkRequiredLWMA: Height %i: Skipping %s (wrong blocktype)\n", pindexLast->nHeight, pindexLast->GetBlockHeader().GetHash().ToString().c_str());
             assert(pindexLast->pprev);
             pindexLast = pindexLast->pprev;
@@ -282,7 +283,7 @@ unsigned int GetNextWorkRequiredLWMA2(const CBlockIndex* pindexLast, const CBloc
 
     // Loop through N most recent blocks.
     for (int i = height - N; i < height; i++) {
-        if (pindexLast->GetBlockHeader().GetPoWType() != powType) {
+        if (pindexLast->GetPoWType() != powType) {
             if (verbose) LogPrintf("* GetNextWorkRequiredLWMA2: Height %i: Skipping %s (wrong blocktype)\n", pindexLast->nHeight, pindexLast->GetBlockHeader().GetHash().ToString().c_str());
             assert(pindexLast->pprev);
             pindexLast = pindexLast->pprev;
@@ -335,6 +336,45 @@ unsigned int GetNextWorkRequiredLWMA2(const CBlockIndex* pindexLast, const CBloc
     return next_target.GetCompact();
 }
 
+/** The last LWMA3 target computed for each algo, with the tip and params it was computed for */
+struct CLWMA3Target {
+    const CBlockIndex* pindexLast = nullptr;
+    uint256 hashLast;
+    const Consensus::ConsensusParams* pparams = nullptr;
+    unsigned int nBits = 0;
+};
+static CCriticalSection cs_lwma3;
+static CLWMA3Target lwma3Targets[NUM_BLOCK_TYPES];
+
+static bool GetCachedLWMA3Target(const CBlockIndex* pindexLast, const Consensus::ConsensusParams& params, const POW_TYPE powType, unsigned int& nBits)
+{
+    // Index entries outside of mapBlockIndex have no hash and are never cached
+    if (!pindexLast->phashBlock || powType >= NUM_BLOCK_TYPES)
+        return false;
+
+    LOCK(cs_lwma3);
+    const CLWMA3Target& cached = lwma3Targets[powType];
+    if (cached.pindexLast != pindexLast || cached.pparams != &params || cached.hashLast != *pindexLast->phashBlock)
+        return false;
+
+    nBits = cached.nBits;
+    return true;
+}
+
+static unsigned int CacheLWMA3Target(const CBlockIndex* pindexLast, const Consensus::ConsensusParams& params, const POW_TYPE powType, unsigned int nBits)
+{
+    if (!pindexLast->phashBlock || powType >= NUM_BLOCK_TYPES)
+        return nBits;
+
+    LOCK(cs_lwma3);
+    CLWMA3Target& cached = lwma3Targets[powType];
+    cached.pindexLast = pindexLast;
+    cached.hashLast = *pindexLast->phashBlock;
+    cached.pparams = &params;
+    cached.nBits = nBits;
+    return nBits;
+}
+
 unsigned int GetNextWorkRequiredLWMA3(const CBlockIndex* pindexLast, const CBlockHeader* pblock, const Consensus::ConsensusParams& params, const POW_TYPE powType)
 {
     // Originally from XVG repository - modified by AVN team
@@ -353,22 +393,31 @@ unsigned int GetNextWorkRequiredLWMA3(const CBlockIndex* pindexLast, const CBloc
     const int64_t T = params.nPowTargetSpacing * 2;                               // Target freq 30s x 2 algos
     const int64_t N = 60;                                                         // Window size - 60 as per zawy12 graphs
     const int64_t k = N * (N + 1) * T / 2;                                        // Constant for proper averaging after weighting solvetimes == 109800
-    const int64_t height = pindexLast->nHeight + 1;                               // Block height, last + 1, since we are finding next block diff
+
+    // The target only depends on the tip and the algo, which are asked for again for every header, block and template on that tip
+    unsigned int nCachedBits;
+    if (GetCachedLWMA3Target(pindexLast, params, powType, nCachedBits))
+        return nCachedBits;
 
     arith_uint256 sum_target;
     int64_t t = 0, j = 0;
     int64_t solvetime = 0;
 
-    std::vector<const CBlockIndex*> SameAlgoBlocks;
-    for (int c = height - 1; SameAlgoBlocks.size() < (N + 1); c--) {
-        const CBlockIndex* block = pindexLast->GetAncestor(c); // -1 after execution
-        if (block->GetBlockHeader().GetPoWType() == powType) {
-            SameAlgoBlocks.push_back(block);
-        }
+    // Walk to the most recent block of this algo, then hop back along the same algo links.
+    // If there are not enough blocks with this algo above height 100, return powLimit until dataset is big enough
+    const CBlockIndex* pindex = pindexLast;
+    while (pindex && pindex->GetPoWType() != powType) {
+        if (pindex->nHeight < 100)
+            return CacheLWMA3Target(pindexLast, params, powType, powLimit.GetCompact());
+        pindex = pindex->pprev;
+    }
 
-        if (c < 100) { // If there are not enough blocks with this algo, return powLimit until dataset is big enough
-            return powLimit.GetCompact();
-        }
+    std::vector<const CBlockIndex*> SameAlgoBlocks;
+    SameAlgoBlocks.reserve(N + 1);
+    for (; SameAlgoBlocks.size() < (N + 1); pindex = pindex->pprevSameAlgo) {
+        if (!pindex || pindex->nHeight < 100)
+            return CacheLWMA3Target(pindexLast, params, powType, powLimit.GetCompact());
+        SameAlgoBlocks.push_back(pindex);
     }
     // Creates vector with {block1000, block997, block993}, so we start at the back
 
@@ -400,7 +449,7 @@ unsigned int GetNextWorkRequiredLWMA3(const CBlockIndex* pindexLast, const CBloc
         next_target = powLimit;
     }
 
-    return next_target.GetCompact();
+    return CacheLWMA3Target(pindexLast, params, powType, next_target.GetCompact());
 }
 
 // Call correct diff adjust for blocks prior to Dual Algo
@@ -13,6 +13,7 @@
 
 #include "algo/minotaurx/minotaurx.h" // Minotaurx Algo
 #include "algo/x16r/x16r.h"
+#include "algo/x16r/x16r_midstate.h"
 
 #include "primitives/block.h"
 #include "primitives/powcache.h"
@@ -33,48 +34,54 @@ uint256 CBlockHeader::GetSHA256Hash() const
     return SerializeHash(*this);
 }
 
-uint256 CBlockHeader::ComputePoWHash() const
-{
-    uint256 thash;
-    unsigned int profile = 0x0;
+// Yespower scratch area of the current thread, freed when the thread exits
+static thread_local CYespowerLocal yespowerLocalThread;
 
+bool CBlockHeader::GetX16RSelectorHash(uint256& hashSelector) const
+{
     uint32_t nX16rtTimestamp = Params().GetConsensus().vUpgrades[Consensus::UPGRADE_X16RT_SWITCH].nTimestamp;
     uint32_t nDualAlgoTimestamp = Params().GetConsensus().vUpgrades[Consensus::UPGRADE_DUAL_ALGO].nTimestamp;
 
     if (nTime > nX16rtTimestamp) {
-        if (nTime > nDualAlgoTimestamp) {
-            // Mutli algo (x16rt + Minotaurx algo)
-            switch (GetPoWType()) {
-            case POW_TYPE_X16RT: {
-                int32_t nTimeX16r = nTime & TIME_MASK;
-                uint256 hashTime = Hash(BEGIN(nTimeX16r), END(nTimeX16r));
-                thash = HashX16R(BEGIN(nVersion), END(nNonce), hashTime);
-                break;
-            }
-            case POW_TYPE_MINOTAURX: {
-                return Minotaurx(BEGIN(nVersion), END(nNonce), true);
-                break;
-            }
-            default: // Don't crash the client on invalid blockType, just return a bad hash
-                return HIGH_HASH;
-            }
-        } else {
-            // x16rt before dual-algo
-            int32_t nTimeX16r = nTime & TIME_MASK;
-            uint256 hashTime = Hash(BEGIN(nTimeX16r), END(nTimeX16r));
-            thash = HashX16R(BEGIN(nVersion), END(nNonce), hashTime);
-        }
+        // Mutli algo (x16rt + Minotaurx algo)
+        if (nTime > nDualAlgoTimestamp && GetPoWType() != POW_TYPE_X16RT)
+            return false;
+
+        // x16rt
+        int32_t nTimeX16r = nTime & TIME_MASK;
+        hashSelector = Hash(BEGIN(nTimeX16r), END(nTimeX16r));
     } else {
         // x16r
-        thash = HashX16R(BEGIN(nVersion), END(nNonce), hashPrevBlock);
+        hashSelector = hashPrevBlock;
     }
+    return true;
+}
+
+uint256 CBlockHeader::ComputePoWHash(yespower_local_t* local) const
+{
+    uint256 hashSelector;
+    if (GetX16RSelectorHash(hashSelector))
+        return HashX16R(BEGIN(nVersion), END(nNonce), hashSelector);
+
+    // Only dual algo headers can get here
+    if (GetPoWType() == POW_TYPE_MINOTAURX)
+        return Minotaurx(BEGIN(nVersion), END(nNonce), true, local ? local : yespowerLocalThread.get());
+
+    // Don't crash the client on invalid blockType, just return a bad hash
+    return HIGH_HASH;
+}
 
-    return thash;
+// Store a computed PoW hash, logging it if it contradicts the one the cache held
+static void StorePoWHash(CPowCache& cache, const uint256& headerHash, bool found, const uint256& powHashCached, const uint256& powHash)
+{
+    if (found && powHash != powHashCached) {
+        LogPrintf("PowCache failure: headerHash: %s, from cache: %s, computed: %s, correcting\n", headerHash.ToString(), powHashCached.ToString(), powHash.ToString());
+    }
+    cache.insert(headerHash, powHash); // If it exists, replace it.
 }
 
 uint256 CBlockHeader::GetHash(bool readCache) const
 {
-    LOCK(cs_pow);
     CPowCache& cache(CPowCache::Instance());
 
     uint256 headerHash = GetSHA256Hash();
@@ -86,21 +93,48 @@ uint256 CBlockHeader::GetHash(bool readCache) const
     }
 
     if (!found || cache.IsValidate()) {
+        // The expensive PoW hash is computed without holding any lock, only the
+        // cache shard is locked for the insert. Two threads racing on the same
+        // header both compute the same value, so the duplicate insert is harmless.
         uint256 powHash2 = ComputePoWHash();
-        if (found && powHash2 != powHash) {
-            LogPrintf("PowCache failure: headerHash: %s, from cache: %s, computed: %s, correcting\n", headerHash.ToString(), powHash.ToString(), powHash2.ToString());
-        }
+        StorePoWHash(cache, headerHash, found, powHash, powHash2);
         powHash = powHash2;
-        cache.erase(headerHash); // If it exists, replace it.
-        cache.insert(headerHash, powHash2);
     }
     return powHash;
 }
 
+void CBlockHeader::CachePoWHashesLanes(const std::vector<const CBlockHeader*>& vpHeaders, const uint256& hashSelector)
+{
+    assert(vpHeaders.size() == X16R_LANES);
+
+    // Like GetHash(), headers already cached are only hashed again to validate the cache
+    CPowCache& cache(CPowCache::Instance());
+    uint256 vHeaderHash[X16R_LANES];
+    uint256 vCachedHash[X16R_LANES];
+    bool vFound[X16R_LANES];
+    bool fAllFound = true;
+    const unsigned char* vpData[X16R_LANES];
+    for (int k = 0; k < X16R_LANES; k++) {
+        vHeaderHash[k] = vpHeaders[k]->GetSHA256Hash();
+        vFound[k] = cache.get(vHeaderHash[k], vCachedHash[k]);
+        fAllFound &= vFound[k];
+        vpData[k] = (const unsigned char*)&vpHeaders[k]->nVersion;
+    }
+    if (fAllFound && !cache.IsValidate())
+        return;
+
+    uint256 vPowHash[X16R_LANES];
+    HashX16RLanes(vpData, hashSelector, vPowHash);
+    for (int k = 0; k < X16R_LANES; k++) {
+        if (!vFound[k] || cache.IsValidate())
+            StorePoWHash(cache, vHeaderHash[k], vFound[k], vCachedHash[k], vPowHash[k]);
+    }
+}
+
 // Minotaurx algo
 uint256 CBlockHeader::MinotaurxHashArbitrary(const char* data)
 {
-    return Minotaurx(data, data + strlen(data), true);
+    return Minotaurx(data, data + strlen(data), true, yespowerLocalThread.get());
 }
 
 uint256 CBlockHeader::GetX16RHash() const
@@ -16,6 +16,8 @@
 #include "unordered_lru_cache.h"
 #include "util.h"
 
+#include "algo/minotaurx/yespower/yespower.h"
+
 // Dual Algo: An impossible pow hash (can't meet any target)
 const uint256 HIGH_HASH = uint256S("0x0fffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff");
 
@@ -35,6 +37,27 @@ enum POW_TYPE {
     NUM_BLOCK_TYPES
 };
 
+/**
+ * Owner of a yespower scratch area for MinotaurX hashing.
+ * The memory is allocated by the first hash and reused by every following
+ * one, so long-lived hashing threads should keep one around. Not thread safe:
+ * use one instance per thread.
+ */
+class CYespowerLocal
+{
+private:
+    yespower_local_t local;
+
+public:
+    CYespowerLocal() { yespower_init_local(&local); }
+    ~CYespowerLocal() { yespower_free_local(&local); }
+
+    CYespowerLocal(const CYespowerLocal&) = delete;
+    CYespowerLocal& operator=(const CYespowerLocal&) = delete;
+
+    yespower_local_t* get() { return &local; }
+};
+
 /** Nodes collect new transactions into a block, hash them into a hash tree,
  * and scan through nonce values to make the block's hash satisfy proof-of-work
  * requirements.  When they solve the proof-of-work, they broadcast the block
@@ -90,8 +113,9 @@ public:
     /// Compute the SHA256 hash from the block
     uint256 GetSHA256Hash() const;
 
-    /// Compute the PoW hash
-    uint256 ComputePoWHash() const;
+    /// Compute the PoW hash, optionally using the given yespower scratch area
+    /// (default: a scratch area owned by the calling thread)
+    uint256 ComputePoWHash(yespower_local_t* local = nullptr) const;
 
     /// Caching lookup/computation of POW hash
     uint256 GetHash(bool readCache = true) const;
@@ -99,6 +123,15 @@ public:
     /// Compute X16R hash
     uint256 GetX16RHash() const;
 
+    /// Dual Algo: Get the hash selecting the X16R algorithm order (the time hash for X16RT,
+    /// hashPrevBlock for X16R). Returns false if the header isn't hashed with X16R(T).
+    bool GetX16RSelectorHash(uint256& hashSelector) const;
+
+    /// Compute the PoW hashes of X16R_LANES headers sharing one X16R selector hash in
+    /// lockstep (see HashX16RLanes) and store them in the PoW cache. Does nothing when all
+    /// are cached already, unless -powcachevalidate checks the cached hashes like GetHash()
+    static void CachePoWHashesLanes(const std::vector<const CBlockHeader*>& vpHeaders, const uint256& hashSelector);
+
     // Dual Algo: MinotaurX
     static uint256 MinotaurxHashArbitrary(const char* data);
 
@@ -9,39 +9,45 @@
 #include "sync.h"
 #include "../util.h"
 
-CCriticalSection cs_pow;
+#include <mutex>
 
 CPowCache* CPowCache::instance = nullptr;
 
 CPowCache& CPowCache::Instance()
 {
-    if (CPowCache::instance == nullptr)
-    {
+    // Header hashing happens on many threads, make sure only one of them creates the cache
+    static std::once_flag initFlag;
+    std::call_once(initFlag, []() {
         int powCacheSize = gArgs.GetArg("-powhashcache", DEFAULT_POW_CACHE_SIZE);
         bool powCacheValidate = gArgs.GetArg("-powcachevalidate", 0) > 0 ? true : false;
-        powCacheSize = powCacheSize == 0 ? DEFAULT_POW_CACHE_SIZE : powCacheSize;
+        powCacheSize = powCacheSize <= 0 ? DEFAULT_POW_CACHE_SIZE : powCacheSize;
 
         CPowCache::instance = new CPowCache(powCacheSize, powCacheValidate);
-    }
+    });
     return *instance;
 }
 
 void CPowCache::DoMaintenance()
 {
-    LOCK(cs_pow);
+    LOCK(cs);
     // If cache has grown enough, save it:
-    if (cacheMap.size() - nLoadedSize > 100)
+    if (size() > nLoadedSize + 100)
     {
         CFlatDB<CPowCache> flatDb("powcache.dat", "powCache");
         flatDb.Dump(*this);
     }
 }
 
-CPowCache::CPowCache(int maxSize, bool validate) : unordered_lru_cache<uint256, uint256, std::hash<uint256>>(maxSize),
+CPowCache::CPowCache(int maxSize, bool validate) :
    nVersion(CURRENT_VERSION),
    nLoadedSize(0),
    bValidate(validate)
 {
+    size_t nShardSize = std::max<size_t>(1, (size_t)maxSize / NUM_SHARDS);
+    vShards.reserve(NUM_SHARDS);
+    for (size_t i = 0; i < NUM_SHARDS; i++) {
+        vShards.emplace_back(new Shard(nShardSize));
+    }
     if (bValidate) LogPrintf("PowCache: Validation and auto correction enabled\n");
 }
 
@@ -49,9 +55,43 @@ CPowCache::~CPowCache()
 {
 }
 
+bool CPowCache::get(const uint256& headerHash, uint256& powHash)
+{
+    Shard& shard = GetShard(headerHash);
+    LOCK(shard.cs);
+    return shard.cache.get(headerHash, powHash);
+}
+
+void CPowCache::insert(const uint256& headerHash, const uint256& powHash)
+{
+    Shard& shard = GetShard(headerHash);
+    LOCK(shard.cs);
+    shard.cache.insert(headerHash, powHash); // Replaces any existing entry
+}
+
+void CPowCache::erase(const uint256& headerHash)
+{
+    Shard& shard = GetShard(headerHash);
+    LOCK(shard.cs);
+    shard.cache.erase(headerHash);
+}
+
+size_t CPowCache::size() const
+{
+    size_t nSize = 0;
+    for (const auto& shard : vShards) {
+        LOCK(shard->cs);
+        nSize += shard->cache.size();
+    }
+    return nSize;
+}
+
 void CPowCache::Clear()
 {
-   cacheMap.clear();
+    for (const auto& shard : vShards) {
+        LOCK(shard->cs);
+        shard->cache.clear();
+    }
 }
 
 void CPowCache::CheckAndRemove()
@@ -61,6 +101,6 @@ void CPowCache::CheckAndRemove()
 std::string CPowCache::ToString() const
 {
     std::ostringstream info;
-    info << "PowCache: elements: " << (int)cacheMap.size();
+    info << "PowCache: elements: " << (int)size() << ", shards: " << (int)NUM_SHARDS;
     return info.str();
 }
@@ -12,18 +12,45 @@
 #include "unordered_lru_cache.h"
 #include "util.h"
 
-extern CCriticalSection cs_pow;
-
-class CPowCache : public unordered_lru_cache<uint256, uint256, std::hash<uint256>>
+#include <memory>
+#include <vector>
+
+/**
+ * Cache of header hash -> PoW hash.
+ *
+ * The cache is split into a fixed number of independently locked shards, so
+ * concurrent lookups and inserts only contend when they hit the same shard.
+ * The PoW hash itself is always computed by the caller outside of any lock.
+ */
+class CPowCache
 {
     private:
+        typedef unordered_lru_cache<uint256, uint256, std::hash<uint256>> ShardMap;
+
+        struct Shard
+        {
+            CCriticalSection cs;
+            ShardMap cache;
+
+            explicit Shard(size_t maxSize) : cache(maxSize) {}
+        };
+
         static CPowCache* instance;
         static const int CURRENT_VERSION = 1;
+        static const size_t NUM_SHARDS = 64;
 
         int nVersion;
-        int nLoadedSize;
+        size_t nLoadedSize;
         bool bValidate;
         CCriticalSection cs;
+        std::vector<std::unique_ptr<Shard>> vShards;
+
+        Shard& GetShard(const uint256& headerHash) const
+        {
+            // The low 64 bits are used by std::hash<uint256> for bucketing inside a shard,
+            // so pick the shard from a different word.
+            return *vShards[headerHash.GetUint64(1) % NUM_SHARDS];
+        }
 
     public:
         static CPowCache& Instance();
@@ -31,6 +58,11 @@ class CPowCache : public unordered_lru_cache<uint256, uint256, std::hash<uint256
         CPowCache(int maxSize = DEFAULT_POW_CACHE_SIZE, bool validate = false);
         virtual ~CPowCache();
 
+        bool get(const uint256& headerHash, uint256& powHash);
+        void insert(const uint256& headerHash, const uint256& powHash);
+        void erase(const uint256& headerHash);
+        size_t size() const;
+
         void Clear();
         void CheckAndRemove();
         bool IsValidate() const { return bValidate; }
@@ -38,8 +70,6 @@ class CPowCache : public unordered_lru_cache<uint256, uint256, std::hash<uint256
 
         std::string ToString() const;
 
-
-
         ADD_SERIALIZE_METHODS
 
         template <typename Stream, typename Operation>
@@ -48,32 +78,47 @@ class CPowCache : public unordered_lru_cache<uint256, uint256, std::hash<uint256
             LOCK(cs);
             READWRITE(nVersion);
 
-            uint64_t cacheSize = (uint64_t)cacheMap.size();
-            READWRITE(COMPACTSIZE(cacheSize));
-
             if (ser_action.ForRead())
             {
+                uint64_t cacheSize = 0;
+                READWRITE(COMPACTSIZE(cacheSize));
+
                 uint256 headerHash;
                 uint256 powHash;
-                for (int i = 0; i < cacheSize; ++i)
+                for (uint64_t i = 0; i < cacheSize; ++i)
                 {
                     READWRITE(headerHash);
                     READWRITE(powHash);
                     insert(headerHash, powHash);
                 }
                 nVersion = CURRENT_VERSION;
-                nLoadedSize = cacheMap.size();
+                nLoadedSize = size();
             }
             else
             {
-                for (auto it = cacheMap.begin(); it != cacheMap.end(); ++it)
+                // Hold every shard for the duration of the write so the element
+                // count matches what is serialized.
+                std::vector<std::unique_lock<CCriticalSection>> vLocks;
+                vLocks.reserve(vShards.size());
+                uint64_t cacheSize = 0;
+                for (const auto& shard : vShards)
                 {
-                    uint256 headerHash = it->first;
-                    uint256 powHash    = it->second.first;
-                    READWRITE(headerHash);
-                    READWRITE(powHash);
-                };
-                nLoadedSize = cacheMap.size(); // The size on disk is current
+                    vLocks.emplace_back(shard->cs);
+                    cacheSize += shard->cache.size();
+                }
+                READWRITE(COMPACTSIZE(cacheSize));
+
+                for (const auto& shard : vShards)
+                {
+                    for (auto it = shard->cache.begin(); it != shard->cache.end(); ++it)
+                    {
+                        uint256 headerHash = it->first;
+                        uint256 powHash    = it->second.first;
+                        READWRITE(headerHash);
+                        READWRITE(powHash);
+                    }
+                }
+                nLoadedSize = cacheSize; // The size on disk is current
             }
         }
 };
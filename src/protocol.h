@@ -262,6 +262,13 @@ extern const char *ASSETDATA;
  * @since protocol version 70018.
  */
     extern const char *ASSETNOTFOUND;
+
+/**
+ * Contains the AssetData of every asset of a getassetdata message, in the order requested.
+ * Sent in response to a "getassetdata" message, instead of one assetdata message per asset.
+ * @since protocol version 70035.
+ */
+extern const char *ASSETDATAS;
 };
 
 /* Get a vector of all valid message types (see above) */
@@ -357,11 +357,11 @@ UniValue UpdateGlobalRestrictedAsset(const JSONRPCRequest& request, const int8_t
         throw JSONRPCError(RPC_INVALID_PARAMETER, std::string("Unsupported asset type: ") + AssetTypeToString(assetType));
     }
 
-    if (flag == 1 && mempool.mapGlobalFreezingAssetTransactions.count(restricted_name)) {
+    if (flag == 1 && mempool.HasAssetDependents(MemPoolAssetDependency::GLOBAL_FREEZE, restricted_name)) {
         throw JSONRPCError(RPC_TRANSACTION_REJECTED, std::string("Freezing transaction already in mempool"));
     }
 
-    if (flag == 0 && mempool.mapGlobalUnFreezingAssetTransactions.count(restricted_name)) {
+    if (flag == 0 && mempool.HasAssetDependents(MemPoolAssetDependency::GLOBAL_UNFREEZE, restricted_name)) {
         throw JSONRPCError(RPC_TRANSACTION_REJECTED, std::string("Unfreezing transaction already in mempool"));
     }
 
@@ -1128,15 +1128,61 @@ UniValue listmyassets(const JSONRPCRequest& request)
 
 #endif
 
+//  Addresses in the order the assets database keeps them, its keys serialize the length of a string first
+struct AssetAddressDbOrder
+{
+    bool operator()(const std::string& a, const std::string& b) const
+    {
+        return a.size() != b.size() ? a.size() < b.size() : a < b;
+    }
+};
+
+//  Read a page of the holders of an asset following after_address (from the first holder when it is empty)
+//      without flushing the asset cache: the page read from the database is merged with the balances of the
+//      asset held in passets, the latest ones
+static bool ReadAssetAddressPage(const std::string& asset_name, const std::string& after_address, size_t count, std::vector<std::pair<std::string, CAmount>>& vecAddressAmounts)
+{
+    AssertLockHeld(cs_main);
+    if (!passetsdb || !passets)
+        return false;
+
+    std::vector<std::pair<std::string, CAmount>> vecDbAmounts;
+    std::string next_address;
+    if (!passetsdb->AssetAddressDirFrom(vecDbAmounts, asset_name, after_address, count, next_address))
+        return false;
+
+    //  Holders the database has more of are only complete up to the last one read, the others are on later pages
+    AssetAddressDbOrder order;
+    std::map<std::string, CAmount, AssetAddressDbOrder> mapAmounts(vecDbAmounts.begin(), vecDbAmounts.end());
+    for (const auto& item : passets->mapAssetsAddressAmount) {
+        const std::string& address = item.first.second;
+        if (item.first.first != asset_name || (!after_address.empty() && !order(after_address, address)))
+            continue;
+        if (!next_address.empty() && order(next_address, address))
+            continue;
+        mapAmounts[address] = item.second;
+    }
+
+    for (const auto& amount : mapAmounts) {
+        if (vecAddressAmounts.size() == count)
+            break;
+        //  Balances that dropped to zero are erased from the database when the cache is flushed
+        if (amount.second > 0)
+            vecAddressAmounts.push_back(amount);
+    }
+
+    return true;
+}
+
 UniValue listaddressesbyasset(const JSONRPCRequest& request)
 {
     if (!fAssetIndex) {
         return "_This rpc call is not functional unless -assetindex is enabled. To enable, please run the wallet with -assetindex, this will require a reindex to occur";
     }
 
-    if (request.fHelp || !AreAssetsDeployed() || request.params.size() > 4 || request.params.size() < 1)
+    if (request.fHelp || !AreAssetsDeployed() || request.params.size() > 5 || request.params.size() < 1)
         throw std::runtime_error(
-            "listaddressesbyasset \"asset_name\" (onlytotal) (count) (start)\n" + AssetActivationWarning() +
+            "listaddressesbyasset \"asset_name\" (onlytotal) (count) (start) (\"after_address\")\n" + AssetActivationWarning() +
             "\nReturns a list of all address that own the given asset (with balances)"
             "\nOr returns the total size of how many address own the given asset"
 
@@ -1145,6 +1191,7 @@ UniValue listaddressesbyasset(const JSONRPCRequest& request)
             "2. \"onlytotal\"                (boolean, optional, default=false) when false result is just a list of addresses with balances -- when true the result is just a single number representing the number of addresses\n"
             "3. \"count\"                    (integer, optional, default=50000, MAX=50000) truncates results to include only the first _count_ assets found\n"
             "4. \"start\"                    (integer, optional, default=0) results skip over the first _start_ assets found (if negative it skips back from the end)\n"
+            "5. \"after_address\"            (string, optional) return the addresses following this one, pass the last address of the previous page to continue a listing. Cannot be combined with start\n"
 
             "\nResult:\n"
             "[ "
@@ -1153,7 +1200,7 @@ UniValue listaddressesbyasset(const JSONRPCRequest& request)
             "]\n"
 
             "\nExamples:\n" +
-            HelpExampleCli("listaddressesbyasset", "\"ASSET_NAME\" false 2 0") + HelpExampleCli("listaddressesbyasset", "\"ASSET_NAME\" true") + HelpExampleCli("listaddressesbyasset", "\"ASSET_NAME\""));
+            HelpExampleCli("listaddressesbyasset", "\"ASSET_NAME\" false 2 0") + HelpExampleCli("listaddressesbyasset", "\"ASSET_NAME\" false 1000 0 \"LAST_ADDRESS_OF_PREVIOUS_PAGE\"") + HelpExampleCli("listaddressesbyasset", "\"ASSET_NAME\" true") + HelpExampleCli("listaddressesbyasset", "\"ASSET_NAME\""));
 
     LOCK(cs_main);
 
@@ -1174,14 +1221,26 @@ UniValue listaddressesbyasset(const JSONRPCRequest& request)
         start = request.params[3].get_int();
     }
 
+    std::string after_address;
+    if (request.params.size() > 4) {
+        after_address = request.params[4].get_str();
+        if (!after_address.empty() && start != 0)
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "start and after_address cannot be combined.");
+    }
+
     if (!IsAssetNameValid(asset_name))
         return "_Not a valid asset name";
 
     LOCK(cs_main);
     std::vector<std::pair<std::string, CAmount>> vecAddressAmounts;
     int nTotalEntries = 0;
-    if (!passetsdb->AssetAddressDir(vecAddressAmounts, nTotalEntries, fOnlyTotal, asset_name, count, start))
+    if (!fOnlyTotal && start == 0) {
+        // Seek to the cursor, or to the first holder, without flushing the asset cache
+        if (!ReadAssetAddressPage(asset_name, after_address, count, vecAddressAmounts))
+            throw JSONRPCError(RPC_INTERNAL_ERROR, "couldn't retrieve address asset directory.");
+    } else if (!passetsdb->AssetAddressDir(vecAddressAmounts, nTotalEntries, fOnlyTotal, asset_name, count, start)) {
         throw JSONRPCError(RPC_INTERNAL_ERROR, "couldn't retrieve address asset directory.");
+    }
 
     // If only the number of addresses is wanted return it
     if (fOnlyTotal) {
@@ -1832,12 +1891,19 @@ UniValue getcacheinfo(const JSONRPCRequest& request)
             "\nResult:\n"
             "[\n"
             "  uxto cache size:\n"
+            "  asset total:\n"
             "  asset total (exclude dirty):\n"
             "  asset address map:\n"
             "  asset address balance:\n"
             "  my unspent asset:\n"
             "  reissue data:\n"
-            "  asset metadata map:\n"
+            "  asset metadata cache:\n"
+            "  asset metadata cache max:\n"
+            "  asset metadata cache entries:\n"
+            "  asset metadata cache hits:\n"
+            "  asset metadata cache misses:\n"
+            "  asset metadata cache hit rate:\n"
+            "  asset metadata map:              (same as asset metadata cache)\n"
             "  asset metadata list (est):\n"
             "  dirty cache (est):\n"
 
@@ -1861,7 +1927,9 @@ UniValue getcacheinfo(const JSONRPCRequest& request)
 
     UniValue info(UniValue::VOBJ);
     info.push_back(Pair("uxto cache size", (int)pcoinsTip->DynamicMemoryUsage()));
-    info.push_back(Pair("asset total (exclude dirty)", (int)currentActiveAssetCache->DynamicMemoryUsage()));
+    size_t nAssetTotal = currentActiveAssetCache->DynamicMemoryUsage();
+    info.push_back(Pair("asset total", (int)nAssetTotal));
+    info.push_back(Pair("asset total (exclude dirty)", (int)(nAssetTotal - currentActiveAssetCache->DirtyMemoryUsage())));
 
     UniValue descendants(UniValue::VOBJ);
 
@@ -1870,8 +1938,15 @@ UniValue getcacheinfo(const JSONRPCRequest& request)
 
     info.push_back(Pair("reissue tracking (memory only)", (int)memusage::DynamicUsage(mapReissuedAssets) + (int)memusage::DynamicUsage(mapReissuedTx)));
     info.push_back(Pair("asset data", descendants));
-    info.push_back(Pair("asset metadata map", (int)memusage::DynamicUsage(passetsCache->GetItemsMap())));
-    info.push_back(Pair("asset metadata list (est)", (int)passetsCache->GetItemsList().size() * (32 + 80))); // Max 32 bytes for asset name, 80 bytes max for asset data
+    uint64_t nMetaDataLookups = passetsCache->Hits() + passetsCache->Misses();
+    info.push_back(Pair("asset metadata cache", (int)passetsCache->DynamicMemoryUsage()));
+    info.push_back(Pair("asset metadata cache max", (int)passetsCache->MaxMemory()));
+    info.push_back(Pair("asset metadata cache entries", (int)passetsCache->Size()));
+    info.push_back(Pair("asset metadata cache hits", passetsCache->Hits()));
+    info.push_back(Pair("asset metadata cache misses", passetsCache->Misses()));
+    info.push_back(Pair("asset metadata cache hit rate", nMetaDataLookups ? (double)passetsCache->Hits() / nMetaDataLookups : 0.0));
+    info.push_back(Pair("asset metadata map", (int)passetsCache->DynamicMemoryUsage()));
+    info.push_back(Pair("asset metadata list (est)", (int)passetsCache->Size() * (32 + 80))); // Max 32 bytes for asset name, 80 bytes max for asset data
     info.push_back(Pair("dirty cache (est)", (int)currentActiveAssetCache->GetCacheSize()));
     info.push_back(Pair("dirty cache V2 (est)", (int)currentActiveAssetCache->GetCacheSizeV2()));
 
@@ -2894,12 +2969,16 @@ UniValue getsnapshot(const JSONRPCRequest& request)
 {
     if (request.fHelp || !AreAssetsDeployed() || request.params.size() < 2)
         throw std::runtime_error(
-            "getsnapshot \"asset_name\" block_height\n" + AssetActivationWarning() +
+            "getsnapshot \"asset_name\" block_height ( count start )\n" + AssetActivationWarning() +
             "\nReturns details for the asset snapshot, at the specified height\n"
+            "Without count the owners are sorted by address. Pages list them in snapshot order instead, so that only\n"
+            "the page is held in memory: pass start + count of the previous page as start to get the next one.\n"
 
             "\nArguments:\n"
             "1. \"asset_name\"               (string, required) the name of the asset\n"
             "2. block_height                 (int, required) the block height of the snapshot\n"
+            "3. \"count\"                    (integer, optional, default=ALL) truncates results to include only the first _count_ owners found\n"
+            "4. \"start\"                    (integer, optional, default=0) results skip over the first _start_ owners found\n"
 
             "\nResult:\n"
             "{\n"
@@ -2913,34 +2992,69 @@ UniValue getsnapshot(const JSONRPCRequest& request)
             "}\n"
 
             "\nExamples:\n" +
-            HelpExampleRpc("getsnapshot", "\"ASSET_NAME\" 28546"));
+            HelpExampleRpc("getsnapshot", "\"ASSET_NAME\" 28546") + HelpExampleCli("getsnapshot", "\"ASSET_NAME\" 28546 1000 2000"));
 
 
     std::string asset_name = request.params[0].get_str();
     int block_height = request.params[1].get_int();
 
+    bool fPage = false;
+    size_t count = 0;
+    if (request.params.size() > 2) {
+        if (request.params[2].get_int() < 1)
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "count must be greater than 1.");
+        count = request.params[2].get_int();
+        fPage = true;
+    }
+
+    size_t start = 0;
+    if (request.params.size() > 3) {
+        if (request.params[3].get_int() < 0)
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "start can't be negative.");
+        start = request.params[3].get_int();
+    }
+
     if (!pAssetSnapshotDb)
         throw JSONRPCError(RPC_DATABASE_ERROR, std::string("Asset Snapshot database is not setup. Please restart wallet to try again"));
 
     LOCK(cs_main);
     UniValue result(UniValue::VOBJ);
 
-    CAssetSnapshotDBEntry snapshotDbEntry;
+    //  Owners are streamed in assets database order. A page keeps only its owners and stops reading once it is
+    //      full, the whole list is sorted by address as before
+    std::vector<std::pair<std::string, CAmount>> vOwnersAndAmounts;
+    size_t nSkip = start;
+    bool fPageFull = false;
+    bool found = pAssetSnapshotDb->ForEachOwnerInSnapshot(asset_name, block_height,
+        [&](const std::string& address, CAmount amount) {
+            if (nSkip > 0) {
+                nSkip--;
+                return true;
+            }
+            if (fPage && vOwnersAndAmounts.size() == count) {
+                fPageFull = true;
+                return false;
+            }
+            vOwnersAndAmounts.emplace_back(address, amount);
+            return true;
+        });
 
-    if (pAssetSnapshotDb->RetrieveOwnershipSnapshot(asset_name, block_height, snapshotDbEntry)) {
-        result.push_back(Pair("name", snapshotDbEntry.assetName));
-        result.push_back(Pair("height", snapshotDbEntry.height));
+    if (found || fPageFull) {
+        if (!fPage)
+            std::sort(vOwnersAndAmounts.begin(), vOwnersAndAmounts.end());
 
         UniValue entries(UniValue::VARR);
-        for (auto const& ownerAndAmt : snapshotDbEntry.ownersAndAmounts) {
+        for (auto const & ownerAndAmount : vOwnersAndAmounts) {
             UniValue entry(UniValue::VOBJ);
 
-            entry.push_back(Pair("address", ownerAndAmt.first));
-            entry.push_back(Pair("amount_owned", UnitValueFromAmount(ownerAndAmt.second, snapshotDbEntry.assetName)));
+            entry.push_back(Pair("address", ownerAndAmount.first));
+            entry.push_back(Pair("amount_owned", UnitValueFromAmount(ownerAndAmount.second, asset_name)));
 
             entries.push_back(entry);
         }
 
+        result.push_back(Pair("name", asset_name));
+        result.push_back(Pair("height", block_height));
         result.push_back(Pair("owners", entries));
 
         return result;
@@ -3088,7 +3202,7 @@ static const CRPCCommand commands[] =
         {"assets", "listassetbalancesbyaddress", &listassetbalancesbyaddress, {"address", "onlytotal", "count", "start"}},
         {"assets", "getassetdata", &getassetdata, {"asset_name"}},
         {"assets", "getansdata", &getansdata, {"asset_name"}},
-        {"assets", "listaddressesbyasset", &listaddressesbyasset, {"asset_name", "onlytotal", "count", "start"}},
+        {"assets", "listaddressesbyasset", &listaddressesbyasset, {"asset_name", "onlytotal", "count", "start", "after_address"}},
 #ifdef ENABLE_WALLET
         {"assets", "transferfromaddress", &transferfromaddress, {"asset_name", "from_address", "qty", "to_address", "message", "expire_time", "avn_change_address", "asset_change_address"}},
         {"assets", "transferfromaddresses", &transferfromaddresses, {"asset_name", "from_addresses", "qty", "to_address", "message", "expire_time", "avn_change_address", "asset_change_address"}},
@@ -3120,7 +3234,7 @@ static const CRPCCommand commands[] =
         {"restricted assets", "checkglobalrestriction", &checkglobalrestriction, {"restricted_name"}},
         {"restricted assets", "isvalidverifierstring", &isvalidverifierstring, {"verifier_string"}},
 
-        {"assets", "getsnapshot", &getsnapshot, {"asset_name", "block_height"}},
+        {"assets", "getsnapshot", &getsnapshot, {"asset_name", "block_height", "count", "start"}},
         {"assets", "purgesnapshot", &purgesnapshot, {"asset_name", "block_height"}},
         {"assets", "ansencode", &ansencode, {"type", "data"}},
         {"assets", "ansdecode", &ansdecode, {"ans_id"}},
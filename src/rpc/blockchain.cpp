@@ -57,7 +57,7 @@ extern void TxToJSON(const CTransaction& tx, const uint256 hashBlock, UniValue&
 // XVG
 CBlockIndex* GetLastBlockIndex4Algo(CBlockIndex* pindex, POW_TYPE powType)
 {
-    while (pindex && pindex->pprev && pindex->GetBlockHeader().GetPoWType() != powType)
+    while (pindex && pindex->pprev && pindex->GetPoWType() != powType)
         pindex = pindex->pprev;
     return pindex;
 }
@@ -111,6 +111,8 @@ UniValue blockheaderToJSON(const CBlockIndex* blockindex)
     result.push_back(Pair("bits", strprintf("%08x", blockindex->nBits)));
     result.push_back(Pair("difficulty", GetDifficulty(blockindex)));
     result.push_back(Pair("chainwork", blockindex->nChainWork.GetHex()));
+    for (int i = 0; i < NUM_BLOCK_TYPES; i++)
+        result.push_back(Pair("chainwork_" + POW_TYPE_NAMES[i], blockindex->nChainWorkAlgo[i].GetHex()));
     result.push_back(Pair("nTx", (uint64_t)blockindex->nTx));
 
     if (blockindex->pprev)
@@ -219,6 +221,8 @@ UniValue blockToDeltasJSON(const CBlock& block, const CBlockIndex* blockindex)
         result.push_back(Pair("difficulty_x16rt", GetDifficulty(POW_TYPE_X16RT)));
     }
     result.push_back(Pair("chainwork", blockindex->nChainWork.GetHex()));
+    for (int i = 0; i < NUM_BLOCK_TYPES; i++)
+        result.push_back(Pair("chainwork_" + POW_TYPE_NAMES[i], blockindex->nChainWorkAlgo[i].GetHex()));
 
     if (blockindex->pprev)
         result.push_back(Pair("previousblockhash", blockindex->pprev->GetBlockHash().GetHex()));
@@ -266,6 +270,8 @@ UniValue blockToJSON(const CBlock& block, const CBlockIndex* blockindex, bool tx
         result.push_back(Pair("difficulty_x16rt", GetDifficulty(POW_TYPE_X16RT)));
     }
     result.push_back(Pair("chainwork", blockindex->nChainWork.GetHex()));
+    for (int i = 0; i < NUM_BLOCK_TYPES; i++)
+        result.push_back(Pair("chainwork_" + POW_TYPE_NAMES[i], blockindex->nChainWorkAlgo[i].GetHex()));
 
     if (blockindex->pprev)
         result.push_back(Pair("previousblockhash", blockindex->pprev->GetBlockHash().GetHex()));
@@ -1182,6 +1188,8 @@ UniValue getblockheader(const JSONRPCRequest& request)
             "  \"difficulty\" : x.xxx,  (numeric) The difficulty\n"
             "  \"nTx\", : \"x\",        (string) The number of transactions in the block\n"
             "  \"chainwork\" : \"0000...1f3\"     (string) Expected number of hashes required to produce the current chain (in hex)\n"
+            "  \"chainwork_x16rt\" : \"0000...1f3\"     (string) The part of chainwork mined with x16rt, including all work before dual algo activation (in hex)\n"
+            "  \"chainwork_minotaurx\" : \"0000...1f3\" (string) The part of chainwork mined with minotaurx (in hex)\n"
             "  \"previousblockhash\" : \"hash\",  (string) The hash of the previous block\n"
             "  \"nextblockhash\" : \"hash\",      (string) The hash of the next block\n"
             "}\n"
@@ -1249,6 +1257,8 @@ UniValue getblock(const JSONRPCRequest& request)
             "  \"bits\" : \"1d00ffff\", (string) The bits\n"
             "  \"difficulty\" : x.xxx,  (numeric) The difficulty\n"
             "  \"chainwork\" : \"xxxx\",  (string) Expected number of hashes required to produce the chain up to this block (in hex)\n"
+            "  \"chainwork_x16rt\" : \"xxxx\",  (string) The part of chainwork mined with x16rt, including all work before dual algo activation (in hex)\n"
+            "  \"chainwork_minotaurx\" : \"xxxx\",  (string) The part of chainwork mined with minotaurx (in hex)\n"
             "  \"nTx\", : \"x\",        (string) The number of transactions in the block\n"
             "  \"previousblockhash\" : \"hash\",  (string) The hash of the previous block\n"
             "  \"nextblockhash\" : \"hash\"       (string) The hash of the next block\n"
@@ -1664,6 +1674,7 @@ UniValue getblockchaininfo(const JSONRPCRequest& request)
             "  \"mediantime\": xxxxxx,     (numeric) median time for the current best block\n"
             "  \"verificationprogress\": xxxx, (numeric) estimate of verification progress [0..1]\n"
             "  \"chainwork\": \"xxxx\"     (string) total amount of work in active chain, in hexadecimal\n"
+            "  \"chainwork_algoname\": \"xxxx\" (string) total amount of work in active chain per algorithm, in hexadecimal\n"
             "  \"size_on_disk\": xxxxxx,   (numeric) the estimated size of the block and undo files on disk\n"
             "  \"pruned\": xx,             (boolean) if the blocks are subject to pruning\n"
             "  \"pruneheight\": xxxxxx,    (numeric) lowest-height complete block stored (only present if pruning is enabled)\n"
@@ -1717,6 +1728,8 @@ UniValue getblockchaininfo(const JSONRPCRequest& request)
     obj.push_back(Pair("mediantime", (int64_t)chainActive.Tip()->GetMedianTimePast()));
     obj.push_back(Pair("verificationprogress", GuessVerificationProgress(Params().TxData(), chainActive.Tip())));
     obj.push_back(Pair("chainwork", chainActive.Tip()->nChainWork.GetHex()));
+    for (int i = 0; i < NUM_BLOCK_TYPES; i++)
+        obj.push_back(Pair("chainwork_" + POW_TYPE_NAMES[i], chainActive.Tip()->nChainWorkAlgo[i].GetHex()));
     obj.push_back(Pair("size_on_disk", CalculateCurrentUsage()));
     obj.push_back(Pair("pruned", fPruneMode));
     if (fPruneMode) {
@@ -1877,6 +1890,15 @@ UniValue mempoolInfoToJSON()
     ret.push_back(Pair("maxmempool", (int64_t)maxmempool));
     ret.push_back(Pair("mempoolminfee", ValueFromAmount(mempool.GetMinFee(maxmempool).GetFeePerK())));
 
+    uint64_t nRecheckTxs, nRecheckRemoved;
+    int64_t nRecheckTime;
+    mempool.GetAssetRecheckStats(nRecheckTxs, nRecheckRemoved, nRecheckTime);
+    UniValue assetRechecks(UniValue::VOBJ);
+    assetRechecks.push_back(Pair("checked", nRecheckTxs));
+    assetRechecks.push_back(Pair("removed", nRecheckRemoved));
+    assetRechecks.push_back(Pair("time", nRecheckTime * 0.000001));
+    ret.push_back(Pair("assetrechecks", assetRechecks));
+
     return ret;
 }
 
@@ -1892,8 +1914,13 @@ UniValue getmempoolinfo(const JSONRPCRequest& request)
             "  \"bytes\": xxxxx,              (numeric) Sum of all virtual transaction sizes as defined in BIP 141. Differs from actual serialized size because witness data is discounted\n"
             "  \"usage\": xxxxx,              (numeric) Total memory usage for the mempool\n"
             "  \"maxmempool\": xxxxx,         (numeric) Maximum memory usage for the mempool\n"
-            "  \"mempoolminfee\": xxxxx       (numeric) Minimum fee rate in " +
+            "  \"mempoolminfee\": xxxxx,      (numeric) Minimum fee rate in " +
             CURRENCY_UNIT + "/kB for tx to be accepted\n"
+                            "  \"assetrechecks\": {          (object) Asset dependent transactions rechecked since startup when blocks changed the asset state they depend on\n"
+                            "    \"checked\": xxxxx,          (numeric) Transactions rechecked\n"
+                            "    \"removed\": xxxxx,          (numeric) Transactions removed as no longer valid\n"
+                            "    \"time\": xxxxx              (numeric) Seconds spent rechecking\n"
+                            "  }\n"
                             "}\n"
                             "\nExamples:\n" +
             HelpExampleCli("getmempoolinfo", "") + HelpExampleRpc("getmempoolinfo", ""));
@@ -218,6 +218,8 @@ static const CRPCConvertParam vRPCConvertParams[] =
         {"getdistributestatus", 1, "snapshot_height"},
         {"getdistributestatus", 3, "gross_distribution_amount"},
         {"getsnapshot", 1, "block_height"},
+        {"getsnapshot", 2, "count"},
+        {"getsnapshot", 3, "start"},
         {"purgesnapshot", 1, "block_height"},
         {"stop", 0, "wait"},
         {"getkawpowhash", 3, "height"}};
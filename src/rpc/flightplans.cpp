@@ -32,12 +32,20 @@ UniValue call_flightplan(const JSONRPCRequest& request)
             "2. function           (string, required) Lua function.\n"
             "3. args               (string, not needed) Lua args.\n"
             "\nResult:\n"
-            "1.    (string) Result from called function\n"
+            "{\n"
+            "  \"result\": \"xxxx\",     (string) Result from called function\n"
+            "  \"instructions\": n,    (numeric) Lua instructions run, counted in steps of 1000\n"
+            "  \"memory_peak\": n,     (numeric) most memory the call used, in bytes\n"
+            "  \"elapsed_us\": n       (numeric) time the call took, in microseconds\n"
+            "}\n"
+            "\nA call that fails, including one stopped by -flightplanmaxinstructions, -flightplanmaxmemory or\n"
+            "-flightplantimeout, returns an error whose message ends with the same resources, which are also in\n"
+            "the \"data\" object of the error.\n"
             "\nExamples:\n" +
             HelpExampleCli("call_flightplan", "\"social\" \"getLikes\"") + HelpExampleRpc("call_flightplan", "\"social\" \"getLikes\""));
 
-    LOCK(cs_main);
-
+    // No cs_main here, the avian.data bindings and the RPC methods plans call lock it for themselves. Plans run
+    // concurrently on their own warm states and don't hold up validation for the length of a call.
     if (gArgs.IsArgSet("-flightplans")) {
         std::vector<std::string> args = {};
         std::string file = request.params[0].get_str() + ".lua";
@@ -58,10 +66,21 @@ UniValue call_flightplan(const JSONRPCRequest& request)
         FlightPlanResult result = flightplans.run_file(path.string().c_str(), request.params[1].get_str().c_str(), args);
 
         if (fs::exists(path)) {
+            UniValue resources(UniValue::VOBJ);
+            resources.push_back(Pair("instructions", result.instructions));
+            resources.push_back(Pair("memory_peak", (uint64_t)result.memory_peak));
+            resources.push_back(Pair("elapsed_us", result.micros));
+
             if (result.is_error) {
-                throw JSONRPCError(RPC_MISC_ERROR, result.result);
+                UniValue error = JSONRPCError(RPC_MISC_ERROR, strprintf("%s (instructions: %d, memory_peak: %u, elapsed_us: %d)",
+                                                  result.result, result.instructions, result.memory_peak, result.micros));
+                error.push_back(Pair("data", resources));
+                throw error;
             } else {
-                return result.result;
+                UniValue ret(UniValue::VOBJ);
+                ret.push_back(Pair("result", result.result));
+                ret.pushKVs(resources);
+                return ret;
             }
         } else {
             throw JSONRPCError(RPC_MISC_ERROR, "Flight plan does not exist.");
@@ -101,11 +120,59 @@ UniValue list_flightplans(const JSONRPCRequest& request)
     }
 }
 
+UniValue get_flightplan_stats(const JSONRPCRequest& request)
+{
+    if (!AreFlightPlansDeployed())
+        throw std::runtime_error(
+            "Coming soon: Avian flight plan function will be available in a future release.\n");
+
+    if (request.fHelp)
+        throw std::runtime_error(
+            "get_flightplan_stats\n"
+            "\nCall statistics of the avian flight plans run since startup.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"flight plan name\": {\n"
+            "    \"calls\": n,          (numeric) number of calls\n"
+            "    \"errors\": n,         (numeric) number of calls that returned an error\n"
+            "    \"reloads\": n,        (numeric) number of times the file was recompiled after changing\n"
+            "    \"average_us\": n,     (numeric) average call time in microseconds\n"
+            "    \"max_us\": n,         (numeric) longest call time in microseconds\n"
+            "    \"last_us\": n,        (numeric) last call time in microseconds\n"
+            "    \"max_instructions\": n, (numeric) most Lua instructions run by a call\n"
+            "    \"max_memory\": n      (numeric) most memory used by a call, in bytes\n"
+            "  }, ...\n"
+            "}\n"
+            "\nExamples:\n" +
+            HelpExampleCli("get_flightplan_stats", "") + HelpExampleRpc("get_flightplan_stats", ""));
+
+    if (gArgs.IsArgSet("-flightplans")) {
+        UniValue result(UniValue::VOBJ);
+        for (const auto& entry : AvianFlightPlans::get_stats()) {
+            const FlightPlanStats& stats = entry.second;
+            UniValue plan(UniValue::VOBJ);
+            plan.push_back(Pair("calls", stats.calls));
+            plan.push_back(Pair("errors", stats.errors));
+            plan.push_back(Pair("reloads", stats.reloads));
+            plan.push_back(Pair("average_us", stats.calls ? stats.total_micros / (int64_t)stats.calls : 0));
+            plan.push_back(Pair("max_us", stats.max_micros));
+            plan.push_back(Pair("last_us", stats.last_micros));
+            plan.push_back(Pair("max_instructions", stats.max_instructions));
+            plan.push_back(Pair("max_memory", (uint64_t)stats.max_memory));
+            result.push_back(Pair(fs::path(entry.first).stem().string(), plan));
+        }
+        return result;
+    } else {
+        throw JSONRPCError(RPC_MISC_ERROR, "Flight Plans are experimental and prone to bugs. Please take precautions when using this feature. To enable, launch Avian with the -flightplans flag.");
+    }
+}
+
 static const CRPCCommand commands[] =
     { //  category              name                      actor (function)         argNames
       //  --------------------- ------------------------  -----------------------  ----------
         {"flightplans",         "call_flightplan",        &call_flightplan,        {"flightplan_name", "function", "args"}},
-        {"flightplans",         "list_flightplans",       &list_flightplans,       {}}
+        {"flightplans",         "list_flightplans",       &list_flightplans,       {}},
+        {"flightplans",         "get_flightplan_stats",   &get_flightplan_stats,   {}}
     };
 
 void RegisterFlightPlanRPCCommands(CRPCTable& t)
@@ -5,6 +5,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "rpc/mining.h"
+#include "algo/x16r/x16r_midstate.h"
 #include "amount.h"
 #include "base58.h"
 #include "chain.h"
@@ -68,7 +69,7 @@ UniValue GetNetworkHashPS(int lookup, int height, POW_TYPE powType)
         lookup = pb->nHeight;
 
     // Dual Algo: Skip incorrect powType
-    while (IsDualAlgoEnabled(pb, Params().GetConsensus()) && pb->GetBlockHeader().GetPoWType() != powType) {
+    while (IsDualAlgoEnabled(pb, Params().GetConsensus()) && pb->GetPoWType() != powType) {
         assert(pb->pprev);
         pb = pb->pprev;
     }
@@ -80,12 +81,13 @@ UniValue GetNetworkHashPS(int lookup, int height, POW_TYPE powType)
     // We are either post-fork and with correct powType, or pre-fork and    int64_t minTime = pb->GetBlockTime();
     int64_t minTime = pb->GetBlockTime();
     int64_t maxTime = minTime;
-    arith_uint256 workDiff = GetBlockProof(*pb, powType);
+    const CBlockIndex* pindexLast = pb;
+    const CBlockIndex* pindexFirst = pb;
 
     for (int i = 0; i < lookup; i++) {
         pb = pb->pprev;
 
-        while (IsDualAlgoEnabled(pb, Params().GetConsensus()) && pb->GetBlockHeader().GetPoWType() != powType) {
+        while (IsDualAlgoEnabled(pb, Params().GetConsensus()) && pb->GetPoWType() != powType) {
             assert(pb->pprev);
             pb = pb->pprev;
         }
@@ -96,9 +98,12 @@ UniValue GetNetworkHashPS(int lookup, int height, POW_TYPE powType)
         int64_t time = pb->GetBlockTime();
         minTime = std::min(time, minTime);
         maxTime = std::max(time, maxTime);
-        workDiff += GetBlockProof(*pb, powType);
+        pindexFirst = pb;
     }
 
+    // Blocks of the other pow type in between add no work of this pow type
+    arith_uint256 workDiff = pindexLast->nChainWorkAlgo[powType] - (pindexFirst->pprev ? pindexFirst->pprev->nChainWorkAlgo[powType] : 0);
+
     // In case there's a situation where minTime == maxTime, we don't want a divide by zero exception.
     if (minTime == maxTime)
         return 0;
@@ -168,7 +173,28 @@ UniValue generateBlocks(std::shared_ptr<CReserveScript> coinbaseScript, int nGen
             LOCK(cs_main);
             IncrementExtraNonce(pblock, chainActive.Tip(), nExtraNonce);
         }
-        while (nMaxTries > 0 && pblock->nNonce < nInnerLoopCount && !CheckProofOfWork(pblock->GetBlockHeader(), Params().GetConsensus())) {
+        // For X16R(T) scan the nonces on a midstate of the fixed header fields, and only run
+        // the full (PoW caching) check on a candidate that meets the target.
+        CX16RMidstate midstate;
+        uint256 hashSelector;
+        if (pblock->GetX16RSelectorHash(hashSelector))
+            midstate.Init((const unsigned char*)&pblock->nVersion, hashSelector);
+        arith_uint256 hashTarget = arith_uint256().SetCompact(pblock->nBits);
+        uint256 vLaneHash[X16R_LANES];
+        bool fLanesValid = false;
+        while (nMaxTries > 0 && pblock->nNonce < nInnerLoopCount) {
+            uint32_t nLane = pblock->nNonce % X16R_LANES;
+            if (midstate.IsInitialized() && (nLane == 0 || !fLanesValid)) {
+                uint32_t vNonce[X16R_LANES];
+                for (int k = 0; k < X16R_LANES; k++)
+                    vNonce[k] = pblock->nNonce - nLane + k;
+                midstate.HashLanes(vNonce, vLaneHash);
+                fLanesValid = true;
+            }
+            if (!midstate.IsInitialized() || UintToArith256(vLaneHash[nLane]) <= hashTarget) {
+                if (CheckProofOfWork(pblock->GetBlockHeader(), Params().GetConsensus()))
+                    break;
+            }
             ++pblock->nNonce;
             --nMaxTries;
         }
@@ -590,6 +616,8 @@ UniValue getblocktemplate(const JSONRPCRequest& request)
     // a segwit-block to a non-segwit caller.
     static bool fLastTemplateSupportsSegwit = true;
     static POW_TYPE lastPowType = NUM_BLOCK_TYPES; // Dual Algo
+    // Candidate block updated with the mempool changes between calls, shared by all pow types
+    static CBlockTemplateCache templateCache(Params(), CScript() << OP_TRUE);
     if (pindexPrev != chainActive.Tip() ||
         (mempool.GetTransactionsUpdated() != nTransactionsUpdatedLast && GetTime() - nStart > 5) ||
         fLastTemplateSupportsSegwit != fSupportsSegwit ||
@@ -598,20 +626,19 @@ UniValue getblocktemplate(const JSONRPCRequest& request)
         // Clear pindexPrev so future calls make a new block, despite any failures from here on
         pindexPrev = nullptr;
 
-        // Store the pindexBest used before CreateNewBlock, to avoid races
+        // Store the pindexBest used before GetBlockTemplate, to avoid races
         nTransactionsUpdatedLast = mempool.GetTransactionsUpdated();
         CBlockIndex* pindexPrevNew = chainActive.Tip();
         nStart = GetTime();
         fLastTemplateSupportsSegwit = fSupportsSegwit;
 
-        // Create new block
-        CScript scriptDummy = CScript() << OP_TRUE;
-        pblocktemplate = BlockAssembler(Params()).CreateNewBlock(scriptDummy, fSupportsSegwit, powType); // Dual Algo: Include powType
-        lastPowType = powType;                                                                           // Dual Algo: Cache pow type just requested
+        // Bring the candidate block up to date
+        pblocktemplate = templateCache.GetBlockTemplate(fSupportsSegwit, powType); // Dual Algo: Include powType
+        lastPowType = powType;                                                     // Dual Algo: Cache pow type just requested
         if (!pblocktemplate)
             throw JSONRPCError(RPC_OUT_OF_MEMORY, "Out of memory");
 
-        // Need to update only after we know CreateNewBlock succeeded
+        // Need to update only after we know GetBlockTemplate succeeded
         pindexPrev = pindexPrevNew;
     }
     CBlock* pblock = &pblocktemplate->block; // pointer for convenience
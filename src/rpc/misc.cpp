@@ -14,6 +14,7 @@
 #include "netbase.h"
 #include "rpc/blockchain.h"
 #include "rpc/server.h"
+#include "taskqueue.h"
 #include "timedata.h"
 #include "txdb.h"
 #include "txmempool.h"
@@ -27,6 +28,8 @@
 #endif
 #include "warnings.h"
 
+#include <limits>
+#include <queue>
 #include <stdint.h>
 #ifdef HAVE_MALLOC_INFO
 #include <malloc.h>
@@ -680,18 +683,171 @@ bool getAddressesFromParams(const UniValue& params, std::vector<std::pair<uint16
     return true;
 }
 
-bool heightSort(std::pair<CAddressUnspentKey, CAddressUnspentValue> a,
-    std::pair<CAddressUnspentKey, CAddressUnspentValue> b)
+bool heightSort(const std::pair<CAddressUnspentKey, CAddressUnspentValue>& a,
+    const std::pair<CAddressUnspentKey, CAddressUnspentValue>& b)
 {
     return a.second.blockHeight < b.second.blockHeight;
 }
 
+bool blockOrderSort(const std::pair<CAddressIndexKey, CAmount>& a,
+    const std::pair<CAddressIndexKey, CAmount>& b)
+{
+    if (a.first.blockHeight != b.first.blockHeight)
+        return a.first.blockHeight < b.first.blockHeight;
+    return a.first.txindex < b.first.txindex;
+}
+
 bool timestampSort(std::pair<CMempoolAddressDeltaKey, CMempoolAddressDelta> a,
     std::pair<CMempoolAddressDeltaKey, CMempoolAddressDelta> b)
 {
     return a.second.time < b.second.time;
 }
 
+/** Read the index entries of the addresses on the shared task queue, a single address on the calling thread, then merge the entries of every
+ *  address, each sorted with less, into one list. Equal entries keep the order of the addresses */
+template <typename K, typename V, typename ReadAddress, typename Less>
+static void ReadAddresses(const std::vector<std::pair<uint160, int>>& addresses, std::vector<std::pair<K, V>>& entries, ReadAddress readAddress, Less less)
+{
+    std::vector<std::vector<std::pair<K, V>>> vAddressEntries(addresses.size());
+
+    std::vector<CTaskCheck> vTasks;
+    vTasks.reserve(addresses.size());
+    for (size_t nAddress = 0; nAddress < addresses.size(); nAddress++) {
+        vTasks.emplace_back([&, nAddress]() {
+            std::vector<std::pair<K, V>>& vEntries = vAddressEntries[nAddress];
+            try {
+                if (!readAddress(addresses[nAddress].first, addresses[nAddress].second, vEntries))
+                    return false;
+                if (!std::is_sorted(vEntries.begin(), vEntries.end(), less))
+                    std::stable_sort(vEntries.begin(), vEntries.end(), less);
+            } catch (const std::exception& e) {
+                LogPrintf("%s: %s\n", __func__, e.what());
+                return false;
+            }
+            return true;
+        });
+    }
+    bool fFailed = !RunTasks(vTasks);
+
+    if (fFailed)
+        throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+
+    size_t nTotal = entries.size();
+    for (const auto& vEntries : vAddressEntries)
+        nTotal += vEntries.size();
+    entries.reserve(nTotal);
+
+    if (vAddressEntries.size() == 1) {
+        std::move(vAddressEntries[0].begin(), vAddressEntries[0].end(), std::back_inserter(entries));
+        return;
+    }
+
+    // k-way merge, the queue holds the position of the next entry of every address
+    typedef std::pair<size_t, size_t> Position;
+    auto after = [&](const Position& a, const Position& b) {
+        const std::pair<K, V>& entryA = vAddressEntries[a.first][a.second];
+        const std::pair<K, V>& entryB = vAddressEntries[b.first][b.second];
+        if (less(entryB, entryA))
+            return true;
+        return !less(entryA, entryB) && a.first > b.first;
+    };
+    std::priority_queue<Position, std::vector<Position>, decltype(after)> queue(after);
+    for (size_t nAddress = 0; nAddress < vAddressEntries.size(); nAddress++) {
+        if (!vAddressEntries[nAddress].empty())
+            queue.push(Position(nAddress, 0));
+    }
+    while (!queue.empty()) {
+        Position next = queue.top();
+        queue.pop();
+        entries.push_back(std::move(vAddressEntries[next.first][next.second]));
+        if (++next.second < vAddressEntries[next.first].size())
+            queue.push(next);
+    }
+}
+
+/** Number of index entries in a page of an address RPC called with a cursor and no limit */
+static const int DEFAULT_ADDRESS_PAGE_SIZE = 1000;
+
+/** Encode the index key of the last entry of a page as the cursor to resume after */
+template <typename K>
+static std::string EncodeAddressCursor(const K& key)
+{
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << key;
+    return HexStr(ss.begin(), ss.end());
+}
+
+template <typename K>
+static K DecodeAddressCursor(const std::string& cursor)
+{
+    if (!IsHex(cursor))
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid cursor");
+
+    CDataStream ss(ParseHex(cursor), SER_DISK, CLIENT_VERSION);
+    K key;
+    try {
+        ss >> key;
+    } catch (const std::exception&) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid cursor");
+    }
+    if (!ss.empty())
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid cursor");
+
+    return key;
+}
+
+/** Read up to nLimit index entries of the addresses, address after address, resuming after the cursor.
+ *  readPage reads the entries of one address. Returns the cursor of the next page, empty when all were read */
+template <typename K, typename V, typename ReadPage>
+static std::string ReadAddressPage(const std::vector<std::pair<uint160, int>>& addresses, const std::string& cursor, size_t nLimit, std::vector<std::pair<K, V>>& entries, ReadPage readPage)
+{
+    K after;
+    const K* pAfter = nullptr;
+    bool fReached = cursor.empty();
+    if (!fReached)
+        after = DecodeAddressCursor<K>(cursor);
+
+    for (size_t i = 0; i < addresses.size(); i++) {
+        // Skip the addresses already listed by the previous pages
+        if (!fReached) {
+            if (addresses[i].first != after.hashBytes || (unsigned int)addresses[i].second != after.type)
+                continue;
+            fReached = true;
+            pAfter = &after;
+        }
+
+        bool fMore = false;
+        if (!readPage(addresses[i].first, addresses[i].second, pAfter, nLimit - entries.size(), entries, fMore)) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+        }
+        pAfter = nullptr;
+
+        if (entries.size() == nLimit)
+            return fMore || i + 1 < addresses.size() ? EncodeAddressCursor(entries.back().first) : std::string();
+    }
+
+    if (!fReached)
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Cursor is not for one of the addresses");
+
+    return std::string();
+}
+
+/** Parse the "cursor" of an address RPC, returns whether the call pages with it */
+static bool GetAddressCursorParam(const UniValue& params, std::string& cursor, int& limit)
+{
+    if (!params[0].isObject())
+        return false;
+
+    UniValue cursorParam = find_value(params[0].get_obj(), "cursor");
+    if (cursorParam.isNull())
+        return false;
+
+    cursor = cursorParam.get_str();
+    if (limit == 0)
+        limit = DEFAULT_ADDRESS_PAGE_SIZE;
+    return true;
+}
+
 UniValue getaddressmempool(const JSONRPCRequest& request)
 {
     if (request.fHelp || request.params.size() > 2)
@@ -784,6 +940,7 @@ UniValue getaddressutxos(const JSONRPCRequest& request)
         throw std::runtime_error(
             "getaddressutxos\n"
             "\nReturns all unspent outputs for an address (requires addressindex to be enabled).\n"
+            "The UTXOs of several addresses are returned by height, not grouped by address.\n"
             "\nArguments:\n"
             "{\n"
             "  \"addresses\"\n"
@@ -795,6 +952,7 @@ UniValue getaddressutxos(const JSONRPCRequest& request)
             "  \"assetName\"   (string, optional) Get UTXOs for a particular asset instead of AVN ('*' for all assets).\n"
             "  \"limit\"       (number, optional, default 0) Maximum number of UTXOs to return (0 = no limit)\n"
             "  \"offset\"      (number, optional, default 0) Number of UTXOs to skip\n"
+            "  \"cursor\"      (string, optional) Page through the UTXOs in index order instead of by height: \"\" for the first page, then the \"next\" of the previous page. Pages hold limit UTXOs (default 1000)\n"
             "}\n"
             "\nResult\n"
             "[\n"
@@ -849,20 +1007,23 @@ UniValue getaddressutxos(const JSONRPCRequest& request)
 
     std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue>> unspentOutputs;
 
-    for (std::vector<std::pair<uint160, int>>::iterator it = addresses.begin(); it != addresses.end(); it++) {
-        if (assetName == "*") {
-            if (!GetAddressUnspent((*it).first, (*it).second, unspentOutputs)) {
-                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
-            }
-        } else {
-            if (!GetAddressUnspent((*it).first, (*it).second, assetName, unspentOutputs)) {
-                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
-            }
-        }
+    std::string cursor, next;
+    bool fCursor = GetAddressCursorParam(request.params, cursor, limit);
+    if (fCursor) {
+        // Only read the page from the index
+        std::string assetFilter = assetName == "*" ? std::string() : assetName;
+        next = ReadAddressPage(addresses, cursor, limit, unspentOutputs, [&](const uint160& hash, int type, const CAddressUnspentKey* pAfter, size_t nLimit, std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue>>& entries, bool& fMore) {
+            return GetAddressUnspentPage(hash, type, assetFilter, pAfter, nLimit, entries, fMore);
+        });
+        offset = 0;
+    } else {
+        ReadAddresses(addresses, unspentOutputs, [&](const uint160& hash, int type, std::vector<std::pair<CAddressUnspentKey, CAddressUnspentValue>>& entries) {
+            if (assetName == "*")
+                return GetAddressUnspent(hash, type, entries);
+            return GetAddressUnspent(hash, type, assetName, entries);
+        }, heightSort);
     }
 
-    std::sort(unspentOutputs.begin(), unspentOutputs.end(), heightSort);
-
     UniValue utxos(UniValue::VARR);
 
     size_t startIdx = (size_t)offset;
@@ -898,7 +1059,18 @@ UniValue getaddressutxos(const JSONRPCRequest& request)
         utxos.push_back(output);
     }
 
-    if (includeChainInfo) {
+    if (fCursor) {
+        UniValue result(UniValue::VOBJ);
+        result.push_back(Pair("utxos", utxos));
+        result.push_back(Pair("next", next.empty() ? NullUniValue : UniValue(next)));
+
+        if (includeChainInfo) {
+            LOCK(cs_main);
+            result.push_back(Pair("hash", chainActive.Tip()->GetBlockHash().GetHex()));
+            result.push_back(Pair("height", (int)chainActive.Height()));
+        }
+        return result;
+    } else if (includeChainInfo) {
         UniValue result(UniValue::VOBJ);
         result.push_back(Pair("utxos", utxos));
         result.push_back(Pair("total", (int)unspentOutputs.size()));
@@ -920,6 +1092,7 @@ UniValue getaddressdeltas(const JSONRPCRequest& request)
         throw std::runtime_error(
             "getaddressdeltas\n"
             "\nReturns all changes for an address (requires addressindex to be enabled).\n"
+            "The deltas of several addresses are returned in block order, by height then position in the block, not grouped by address.\n"
             "\nArguments:\n"
             "{\n"
             "  \"addresses\"\n"
@@ -927,12 +1100,13 @@ UniValue getaddressdeltas(const JSONRPCRequest& request)
             "      \"address\"  (string) The base58check encoded address\n"
             "      ,...\n"
             "    ]\n"
-            "  \"start\" (number) The start block height\n"
-            "  \"end\" (number) The end block height\n"
+            "  \"start\" (number, optional) The start block height, only applies together with end\n"
+            "  \"end\" (number, optional) The end block height, only applies together with start\n"
             "  \"chainInfo\" (boolean) Include chain info in results, only applies if start and end specified\n"
             "  \"assetName\"   (string, optional) Get deltas for a particular asset instead of AVN.\n"
             "  \"limit\"       (number, optional, default 0) Maximum number of deltas to return (0 = no limit)\n"
             "  \"offset\"      (number, optional, default 0) Number of deltas to skip\n"
+            "  \"cursor\"      (string, optional) Page through the deltas: \"\" for the first page, then the \"next\" of the previous page. Pages hold limit deltas (default 1000)\n"
             "}\n"
             "\nResult:\n"
             "[\n"
@@ -1003,16 +1177,20 @@ UniValue getaddressdeltas(const JSONRPCRequest& request)
 
     std::vector<std::pair<CAddressIndexKey, CAmount>> addressIndex;
 
-    for (std::vector<std::pair<uint160, int>>::iterator it = addresses.begin(); it != addresses.end(); it++) {
-        if (start > 0 && end > 0) {
-            if (!GetAddressIndex((*it).first, (*it).second, assetName, addressIndex, start, end)) {
-                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
-            }
-        } else {
-            if (!GetAddressIndex((*it).first, (*it).second, assetName, addressIndex)) {
-                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
-            }
-        }
+    std::string cursor, next;
+    bool fCursor = GetAddressCursorParam(request.params, cursor, limit);
+    if (fCursor) {
+        // Only read the page from the index
+        next = ReadAddressPage(addresses, cursor, limit, addressIndex, [&](const uint160& hash, int type, const CAddressIndexKey* pAfter, size_t nLimit, std::vector<std::pair<CAddressIndexKey, CAmount>>& entries, bool& fMore) {
+            return GetAddressIndexPage(hash, type, assetName, start, end, pAfter, nLimit, entries, fMore);
+        });
+        offset = 0;
+    } else {
+        ReadAddresses(addresses, addressIndex, [&](const uint160& hash, int type, std::vector<std::pair<CAddressIndexKey, CAmount>>& entries) {
+            if (start > 0 && end > 0)
+                return GetAddressIndex(hash, type, assetName, entries, start, end);
+            return GetAddressIndex(hash, type, assetName, entries);
+        }, blockOrderSort);
     }
 
     UniValue deltas(UniValue::VARR);
@@ -1064,12 +1242,20 @@ UniValue getaddressdeltas(const JSONRPCRequest& request)
         endInfo.push_back(Pair("height", end));
 
         result.push_back(Pair("deltas", deltas));
-        result.push_back(Pair("total", (int)addressIndex.size()));
-        result.push_back(Pair("limit", limit));
-        result.push_back(Pair("offset", offset));
+        if (fCursor) {
+            result.push_back(Pair("next", next.empty() ? NullUniValue : UniValue(next)));
+        } else {
+            result.push_back(Pair("total", (int)addressIndex.size()));
+            result.push_back(Pair("limit", limit));
+            result.push_back(Pair("offset", offset));
+        }
         result.push_back(Pair("start", startInfo));
         result.push_back(Pair("end", endInfo));
 
+        return result;
+    } else if (fCursor) {
+        result.push_back(Pair("deltas", deltas));
+        result.push_back(Pair("next", next.empty() ? NullUniValue : UniValue(next)));
         return result;
     } else {
         return deltas;
@@ -1123,27 +1309,19 @@ UniValue getaddressbalance(const JSONRPCRequest& request)
         if (!AreAssetsDeployed())
             throw JSONRPCError(RPC_INVALID_PARAMETER, "Assets aren't active.  includeAssets can't be true.");
 
-        std::vector<std::pair<CAddressIndexKey, CAmount>> addressIndex;
+        // assetName -> (received, balance)
+        std::map<std::string, std::pair<CAmount, CAmount>> balances;
 
         for (std::vector<std::pair<uint160, int>>::iterator it = addresses.begin(); it != addresses.end(); it++) {
-            if (!GetAddressIndex((*it).first, (*it).second, addressIndex)) {
+            std::vector<std::pair<std::string, CAddressBalanceValue>> addressBalances;
+            if (!GetAddressBalances((*it).first, (*it).second, addressBalances)) {
                 throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
             }
-        }
-
-        // assetName -> (received, balance)
-        std::map<std::string, std::pair<CAmount, CAmount>> balances;
 
-        for (std::vector<std::pair<CAddressIndexKey, CAmount>>::const_iterator it = addressIndex.begin();
-            it != addressIndex.end(); it++) {
-            std::string assetName = it->first.asset;
-            if (balances.count(assetName) == 0) {
-                balances[assetName] = std::make_pair(0, 0);
-            }
-            if (it->second > 0) {
-                balances[assetName].first += it->second;
+            for (const auto& addressBalance : addressBalances) {
+                balances[addressBalance.first].first += addressBalance.second.received;
+                balances[addressBalance.first].second += addressBalance.second.balance;
             }
-            balances[assetName].second += it->second;
         }
 
         UniValue result(UniValue::VARR);
@@ -1160,23 +1338,16 @@ UniValue getaddressbalance(const JSONRPCRequest& request)
         return result;
 
     } else {
-        std::vector<std::pair<CAddressIndexKey, CAmount>> addressIndex;
-
-        for (std::vector<std::pair<uint160, int>>::iterator it = addresses.begin(); it != addresses.end(); it++) {
-            if (!GetAddressIndex((*it).first, (*it).second, AVN, addressIndex)) {
-                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
-            }
-        }
-
         CAmount balance = 0;
         CAmount received = 0;
 
-        for (std::vector<std::pair<CAddressIndexKey, CAmount>>::const_iterator it = addressIndex.begin();
-            it != addressIndex.end(); it++) {
-            if (it->second > 0) {
-                received += it->second;
+        for (std::vector<std::pair<uint160, int>>::iterator it = addresses.begin(); it != addresses.end(); it++) {
+            CAddressBalanceValue addressBalance;
+            if (!GetAddressBalance((*it).first, (*it).second, AVN, addressBalance)) {
+                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
             }
-            balance += it->second;
+            balance += addressBalance.balance;
+            received += addressBalance.received;
         }
 
         UniValue result(UniValue::VOBJ);
@@ -1193,6 +1364,7 @@ UniValue getaddresstxids(const JSONRPCRequest& request)
         throw std::runtime_error(
             "getaddresstxids\n"
             "\nReturns the txids for an address(es) (requires addressindex to be enabled).\n"
+            "The txids of several addresses are returned once each, in block order.\n"
             "\nArguments:\n"
             "{\n"
             "  \"addresses\"\n"
@@ -1200,10 +1372,12 @@ UniValue getaddresstxids(const JSONRPCRequest& request)
             "      \"address\"  (string) The base58check encoded address\n"
             "      ,...\n"
             "    ]\n"
-            "  \"start\" (number, optional) The start block height\n"
-            "  \"end\" (number, optional) The end block height\n"
+            "  \"start\" (number, optional) The start block height, only applies together with end, with or without cursor\n"
+            "  \"end\" (number, optional) The end block height, only applies together with start, with or without cursor\n"
             "  \"limit\"       (number, optional, default 0) Maximum number of transactions to return (0 = no limit)\n"
             "  \"offset\"      (number, optional, default 0) Number of transactions to skip\n"
+            "  \"cursor\"      (string, optional) Page through the transactions in block order: \"\" for the first page, then the \"next\" of the previous page.\n"
+            "                  A page holds up to limit transactions (default 1000) and returns {\"txids\": [...], \"next\": cursor or null}\n"
             "},\n"
             "\"includeAssets\" (boolean, optional, default false)  If true this will return an expanded result which includes asset transactions\n"
             "\nResult:\n"
@@ -1257,30 +1431,74 @@ UniValue getaddresstxids(const JSONRPCRequest& request)
 
     std::vector<std::pair<CAddressIndexKey, CAmount>> addressIndex;
 
-    for (std::vector<std::pair<uint160, int>>::iterator it = addresses.begin(); it != addresses.end(); it++) {
-        if (includeAssets) {
-            if (start > 0 && end > 0) {
-                if (!GetAddressIndex((*it).first, (*it).second, addressIndex, start, end)) {
-                    throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
-                }
-            } else {
-                if (!GetAddressIndex((*it).first, (*it).second, addressIndex)) {
+    std::string cursor;
+    if (GetAddressCursorParam(request.params, cursor, limit)) {
+        // Pages are in block order over all the addresses and assets, and the cursor is the position in the
+        // chain of the last transaction of the page, so a transaction is on one page only
+        std::pair<int, unsigned int> position;
+        bool fAfter = !cursor.empty();
+        if (fAfter)
+            position = DecodeAddressCursor<std::pair<int, unsigned int>>(cursor);
+
+        // Read up to limit entries of every address and asset after the position. When one of them has more,
+        // only the entries up to the last one read from it are complete
+        bool fMore = false;
+        std::pair<int, unsigned int> bound(std::numeric_limits<int>::max(), std::numeric_limits<unsigned int>::max());
+        for (const auto& address : addresses) {
+            std::vector<std::string> assets;
+            if (!includeAssets)
+                assets.push_back(AVN);
+            else if (!GetAddressIndexAssets(address.first, address.second, assets))
+                throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+
+            for (const std::string& assetName : assets) {
+                CAddressIndexKey after(address.second, address.first, assetName, position.first, position.second, uint256S(std::string(64, 'f')), std::numeric_limits<uint32_t>::max(), true);
+                size_t nBefore = addressIndex.size();
+                bool fAssetMore = false;
+                if (!GetAddressIndexPage(address.first, address.second, assetName, start, end, fAfter ? &after : nullptr, limit, addressIndex, fAssetMore))
                     throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
+                if (fAssetMore && addressIndex.size() > nBefore) {
+                    fMore = true;
+                    bound = std::min(bound, std::make_pair(addressIndex.back().first.blockHeight, addressIndex.back().first.txindex));
                 }
             }
-        } else {
-            if (start > 0 && end > 0) {
-                if (!GetAddressIndex((*it).first, (*it).second, AVN, addressIndex, start, end)) {
-                    throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
-                }
-            } else {
-                if (!GetAddressIndex((*it).first, (*it).second, AVN, addressIndex)) {
-                    throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "No information available for address");
-                }
+        }
+        std::sort(addressIndex.begin(), addressIndex.end(), blockOrderSort);
+
+        UniValue txidsPage(UniValue::VARR);
+        fAfter = false;
+        for (const auto& entry : addressIndex) {
+            std::pair<int, unsigned int> entryPosition(entry.first.blockHeight, entry.first.txindex);
+            if (entryPosition > bound)
+                break;
+            if (fAfter && entryPosition == position)
+                continue;
+            if (txidsPage.size() == (size_t)limit) {
+                fMore = true;
+                break;
             }
+            txidsPage.push_back(entry.first.txhash.GetHex());
+            position = entryPosition;
+            fAfter = true;
         }
+
+        UniValue pageResult(UniValue::VOBJ);
+        pageResult.push_back(Pair("txids", txidsPage));
+        pageResult.push_back(Pair("next", fMore ? UniValue(EncodeAddressCursor(position)) : NullUniValue));
+        return pageResult;
     }
 
+    ReadAddresses(addresses, addressIndex, [&](const uint160& hash, int type, std::vector<std::pair<CAddressIndexKey, CAmount>>& entries) {
+        if (includeAssets) {
+            if (start > 0 && end > 0)
+                return GetAddressIndex(hash, type, entries, start, end);
+            return GetAddressIndex(hash, type, entries);
+        }
+        if (start > 0 && end > 0)
+            return GetAddressIndex(hash, type, AVN, entries, start, end);
+        return GetAddressIndex(hash, type, AVN, entries);
+    }, blockOrderSort);
+
     std::set<std::pair<int, std::string>> txids;
     UniValue result(UniValue::VARR);
 
@@ -0,0 +1,106 @@
+// Copyright (c) 2022 The Avian Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "taskqueue.h"
+
+#include "util.h"
+
+#include <algorithm>
+#include <deque>
+
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+int nTaskQueueThreads = 0;
+
+namespace {
+
+/** The tasks of one RunTasks() call, with its own count of the tasks that are done */
+struct CTaskGroup
+{
+    std::vector<CTaskCheck>& vTasks;
+    size_t nNext;
+    size_t nDone;
+    bool fAllOk;
+    boost::condition_variable condDone;
+
+    explicit CTaskGroup(std::vector<CTaskCheck>& vTasksIn) : vTasks(vTasksIn), nNext(0), nDone(0), fAllOk(true) {}
+};
+
+} // namespace
+
+//  Only held to hand out tasks and count them done, never while one runs
+static boost::mutex csTaskQueue;
+static boost::condition_variable condTaskQueue;
+//  Groups that still have tasks nobody took
+static std::deque<CTaskGroup*> queueTaskGroups;
+
+//  Take the next task of the group, the group leaves the queue with its last one. Requires csTaskQueue
+static CTaskCheck* ClaimTask(CTaskGroup& group)
+{
+    if (group.nNext == group.vTasks.size())
+        return nullptr;
+
+    CTaskCheck* task = &group.vTasks[group.nNext++];
+    if (group.nNext == group.vTasks.size())
+        queueTaskGroups.erase(std::find(queueTaskGroups.begin(), queueTaskGroups.end(), &group));
+    return task;
+}
+
+//  Run a claimed task without the lock, skipping it once another task of the group failed
+static void RunTask(boost::unique_lock<boost::mutex>& lock, CTaskGroup& group, CTaskCheck& task)
+{
+    bool fSkip = !group.fAllOk;
+    lock.unlock();
+    bool fOk = fSkip || task();
+    lock.lock();
+
+    if (!fOk)
+        group.fAllOk = false;
+    if (++group.nDone == group.vTasks.size())
+        group.condDone.notify_all();
+}
+
+void ThreadTaskQueue()
+{
+    RenameThread("avian-tasks");
+
+    boost::unique_lock<boost::mutex> lock(csTaskQueue);
+    while (true) {
+        while (queueTaskGroups.empty())
+            condTaskQueue.wait(lock);
+
+        CTaskGroup& group = *queueTaskGroups.front();
+        RunTask(lock, group, *ClaimTask(group));
+    }
+}
+
+bool RunTasks(std::vector<CTaskCheck>& vTasks)
+{
+    //  Nothing to share, or nobody to share it with
+    if (nTaskQueueThreads == 0 || vTasks.size() <= 1) {
+        for (CTaskCheck& task : vTasks) {
+            if (!task())
+                return false;
+        }
+        return true;
+    }
+
+    //  The group lives on this stack until the workers are done with it
+    boost::this_thread::disable_interruption noInterrupt;
+
+    CTaskGroup group(vTasks);
+    boost::unique_lock<boost::mutex> lock(csTaskQueue);
+    queueTaskGroups.push_back(&group);
+    condTaskQueue.notify_all();
+
+    //  Work on the own tasks, then wait for those the workers took
+    while (CTaskCheck* task = ClaimTask(group))
+        RunTask(lock, group, *task);
+    while (group.nDone < group.vTasks.size())
+        group.condDone.wait(lock);
+
+    return group.fAllOk;
+}
@@ -0,0 +1,43 @@
+// Copyright (c) 2022 The Avian Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef AVIAN_TASKQUEUE_H
+#define AVIAN_TASKQUEUE_H
+
+#include <functional>
+#include <vector>
+
+/** Maximum number of threads of the shared task queue */
+static const int MAX_TASK_QUEUE_THREADS = 8;
+
+/** Number of threads working on the shared task queue, the calling thread included. 0 runs tasks on the calling thread */
+extern int nTaskQueueThreads;
+
+/**
+ * A unit of work for the shared task queue, like a script check but for anything that can be split up,
+ * such as reading the index of several addresses or signing several transactions.
+ */
+class CTaskCheck
+{
+private:
+    std::function<bool()> func;
+
+public:
+    CTaskCheck() {}
+    explicit CTaskCheck(std::function<bool()> funcIn) : func(std::move(funcIn)) {}
+
+    bool operator()() { return func(); }
+
+    void swap(CTaskCheck& check) { func.swap(check.func); }
+};
+
+/** Worker thread of the shared task queue */
+void ThreadTaskQueue();
+
+/** Run the tasks on the shared task queue, the calling thread helping, and wait for them. Calls from different
+ *  threads share the queue's workers and each only waits for its own tasks. A single task runs on the calling
+ *  thread. Tasks are skipped once one fails. Returns whether all of them succeeded */
+bool RunTasks(std::vector<CTaskCheck>& vTasks);
+
+#endif // AVIAN_TASKQUEUE_H
@@ -0,0 +1,135 @@
+// Copyright (c) 2022 The Avian Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "addressindex.h"
+#include "txdb.h"
+#include "validation.h"
+
+#include "test/test_avian.h"
+
+#include <boost/test/unit_test.hpp>
+
+static const std::string ASSET = "ADDRESSINDEX";
+
+static uint160 AddressHash(unsigned char c)
+{
+    uint160 hash;
+    memset(hash.begin(), c, hash.size());
+    return hash;
+}
+
+/** The entries of a block paying to and spending from the addresses */
+static std::vector<std::pair<CAddressIndexKey, CAmount>> BlockEntries(int nHeight, const uint160& hashA, const uint160& hashB)
+{
+    uint256 txid = InsecureRand256();
+    uint256 spendTxid = InsecureRand256();
+    std::vector<std::pair<CAddressIndexKey, CAmount>> entries;
+    entries.emplace_back(CAddressIndexKey(1, hashA, AVN, nHeight, 1, txid, 0, false), 10 * COIN);
+    entries.emplace_back(CAddressIndexKey(1, hashA, AVN, nHeight, 1, txid, 1, false), 5 * COIN);
+    entries.emplace_back(CAddressIndexKey(1, hashA, ASSET, nHeight, 1, txid, 2, false), 7 * COIN);
+    entries.emplace_back(CAddressIndexKey(1, hashB, AVN, nHeight, 1, txid, 3, false), 2 * COIN);
+    entries.emplace_back(CAddressIndexKey(1, hashA, AVN, nHeight, 2, spendTxid, 0, true), -3 * COIN);
+    return entries;
+}
+
+static CAddressBalanceValue ReadBalance(const uint160& hash, const std::string& assetName)
+{
+    CAddressBalanceValue value;
+    BOOST_CHECK(pblocktree->ReadAddressBalance(hash, 1, assetName, value));
+    return value;
+}
+
+static void CheckBalance(const uint160& hash, const std::string& assetName, CAmount nBalance, CAmount nReceived)
+{
+    CAddressBalanceValue value = ReadBalance(hash, assetName);
+    BOOST_CHECK_EQUAL(value.balance, nBalance);
+    BOOST_CHECK_EQUAL(value.received, nReceived);
+}
+
+BOOST_FIXTURE_TEST_SUITE(addressindex_tests, TestingSetup)
+
+    BOOST_AUTO_TEST_CASE(addressbalance_connect_disconnect_test)
+    {
+        BOOST_TEST_MESSAGE("Running Address Balance Connect Disconnect Test");
+
+        uint160 hashA = AddressHash(0x0a), hashB = AddressHash(0x0b);
+        std::vector<std::pair<CAddressIndexKey, CAmount>> block1 = BlockEntries(1, hashA, hashB);
+        std::vector<std::pair<CAddressIndexKey, CAmount>> block2 = BlockEntries(2, hashA, hashB);
+
+        BOOST_CHECK(pblocktree->WriteAddressIndex(block1));
+        CheckBalance(hashA, AVN, 12 * COIN, 15 * COIN);
+        CheckBalance(hashA, ASSET, 7 * COIN, 7 * COIN);
+        CheckBalance(hashB, AVN, 2 * COIN, 2 * COIN);
+
+        // Writing a block again after a crash doesn't count it twice
+        BOOST_CHECK(pblocktree->WriteAddressIndex(block1));
+        CheckBalance(hashA, AVN, 12 * COIN, 15 * COIN);
+
+        BOOST_CHECK(pblocktree->WriteAddressIndex(block2));
+        CheckBalance(hashA, AVN, 24 * COIN, 30 * COIN);
+        CheckBalance(hashB, AVN, 4 * COIN, 4 * COIN);
+
+        std::vector<std::pair<std::string, CAddressBalanceValue>> balances;
+        BOOST_CHECK(pblocktree->ReadAddressBalances(hashA, 1, balances));
+        BOOST_CHECK_EQUAL(balances.size(), 2);
+
+        // Disconnecting the tip in a reorg takes its entries off, erasing them twice is harmless
+        BOOST_CHECK(pblocktree->EraseAddressIndex(block2));
+        CheckBalance(hashA, AVN, 12 * COIN, 15 * COIN);
+        CheckBalance(hashA, ASSET, 7 * COIN, 7 * COIN);
+        BOOST_CHECK(pblocktree->EraseAddressIndex(block2));
+        CheckBalance(hashA, AVN, 12 * COIN, 15 * COIN);
+
+        // Connecting the other branch
+        std::vector<std::pair<CAddressIndexKey, CAmount>> block2b = BlockEntries(2, hashA, hashB);
+        block2b.pop_back();
+        BOOST_CHECK(pblocktree->WriteAddressIndex(block2b));
+        CheckBalance(hashA, AVN, 27 * COIN, 30 * COIN);
+
+        // Balances back to nothing are removed
+        BOOST_CHECK(pblocktree->EraseAddressIndex(block2b));
+        BOOST_CHECK(pblocktree->EraseAddressIndex(block1));
+        balances.clear();
+        BOOST_CHECK(pblocktree->ReadAddressBalances(hashA, 1, balances));
+        BOOST_CHECK(balances.empty());
+        CheckBalance(hashB, AVN, 0, 0);
+    }
+
+    BOOST_AUTO_TEST_CASE(addressbalance_build_test)
+    {
+        BOOST_TEST_MESSAGE("Running Address Balance Build Test");
+
+        uint160 hashA = AddressHash(0x1a), hashB = AddressHash(0x1b), hashC = AddressHash(0x1c);
+        for (int nHeight = 1; nHeight <= 3; nHeight++)
+            BOOST_CHECK(pblocktree->WriteAddressIndex(BlockEntries(nHeight, hashA, hashB)));
+
+        // Balances of an older version of the index: one wrong, one missing and one for an address without entries
+        const char DB_ADDRESSBALANCEINDEX = 'w';
+        BOOST_CHECK(pblocktree->Write(std::make_pair(DB_ADDRESSBALANCEINDEX, CAddressIndexIteratorAssetKey(1, hashA, AVN)), CAddressBalanceValue(1, 1)));
+        BOOST_CHECK(pblocktree->Erase(std::make_pair(DB_ADDRESSBALANCEINDEX, CAddressIndexIteratorAssetKey(1, hashB, AVN))));
+        BOOST_CHECK(pblocktree->Write(std::make_pair(DB_ADDRESSBALANCEINDEX, CAddressIndexIteratorAssetKey(1, hashC, AVN)), CAddressBalanceValue(5, 5)));
+        BOOST_CHECK(pblocktree->WriteAddressBalanceIndexVersion(ADDRESS_BALANCE_INDEX_VERSION - 1));
+
+        // Startup builds the index again when the stored version is older
+        int nVersion;
+        BOOST_CHECK(pblocktree->ReadAddressBalanceIndexVersion(nVersion));
+        BOOST_CHECK(nVersion < ADDRESS_BALANCE_INDEX_VERSION);
+        BOOST_CHECK(pblocktree->BuildAddressBalanceIndex());
+        BOOST_CHECK(pblocktree->ReadAddressBalanceIndexVersion(nVersion));
+        BOOST_CHECK_EQUAL(nVersion, ADDRESS_BALANCE_INDEX_VERSION);
+
+        CheckBalance(hashA, AVN, 36 * COIN, 45 * COIN);
+        CheckBalance(hashA, ASSET, 21 * COIN, 21 * COIN);
+        CheckBalance(hashB, AVN, 6 * COIN, 6 * COIN);
+        CheckBalance(hashC, AVN, 0, 0);
+
+        // And the built index keeps up with new blocks
+        std::vector<std::pair<CAddressIndexKey, CAmount>> block4 = BlockEntries(4, hashA, hashB);
+        BOOST_CHECK(pblocktree->WriteAddressIndex(block4));
+        CheckBalance(hashA, AVN, 48 * COIN, 60 * COIN);
+        BOOST_CHECK(pblocktree->EraseAddressIndex(block4));
+        CheckBalance(hashA, AVN, 36 * COIN, 45 * COIN);
+    }
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -417,6 +417,16 @@ BOOST_FIXTURE_TEST_SUITE(arith_uint256_tests, BasicTestingSetup)
         BOOST_CHECK(R2L / MaxL == ZeroL);
         BOOST_CHECK(MaxL / R2L == 1);
         BOOST_CHECK_THROW(R2L / ZeroL, uint_error);
+
+        // Divisors of 32 bits or less take the short division path
+        const arith_uint256 D3L("ECD75171");
+        for (const arith_uint256& num : {R1L, R2L, MaxL}) {
+            arith_uint256 quotient = num / D3L;
+            BOOST_CHECK(quotient * D3L <= num);
+            BOOST_CHECK(num - quotient * D3L < D3L);
+        }
+        BOOST_CHECK((MaxL / 2) == (MaxL >> 1));
+        BOOST_CHECK((R1L / 0x10000) == (R1L >> 16));
     }
 
 